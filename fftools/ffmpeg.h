@@ -144,6 +144,7 @@ typedef struct OptionsContext {
     int rate_emu;
     float readrate;
     double readrate_initial_burst;
+    int64_t keyframe_seek_interval;
     int accurate_seek;
     int thread_queue_size;
     int input_sync_ref;
@@ -218,7 +219,9 @@ typedef struct OptionsContext {
     SpecifierOptList max_muxing_queue_size;
     SpecifierOptList muxing_queue_data_threshold;
     SpecifierOptList guess_layout_max;
+    SpecifierOptList audio_batch;
     SpecifierOptList apad;
+    SpecifierOptList trim_side_data;
     SpecifierOptList discard;
     SpecifierOptList disposition;
     SpecifierOptList program;
@@ -326,6 +329,9 @@ typedef struct DecoderOpts {
     // Either forced (when DECODER_FLAG_FRAMERATE_FORCED is set) or
     // estimated (otherwise) video framerate.
     AVRational                  framerate;
+
+    // duration of merged audio frames in microseconds, 0 to disable
+    int64_t                     audio_batch;
 } DecoderOpts;
 
 typedef struct Decoder {
@@ -546,6 +552,7 @@ typedef struct OutputStream {
     AVDictionary *sws_dict;
     AVDictionary *swr_opts;
     char *apad;
+    int trim_side_data;
 
     char *attachment_filename;
 
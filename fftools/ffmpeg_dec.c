@@ -65,6 +65,12 @@ typedef struct DecoderPriv {
     int64_t             last_filter_in_rescale_delta;
     int                 last_frame_sample_rate;
 
+    // decoded audio is merged into frames of this duration (in microseconds)
+    // before being sent to the filters, 0 to disable
+    int64_t             audio_batch;
+    AVFrame            *batch;
+    int                 batch_size;
+
     /* previous decoded subtitles */
     AVFrame            *sub_prev[2];
     AVFrame            *sub_heartbeat;
@@ -107,6 +113,7 @@ void dec_free(Decoder **pdec)
     avcodec_free_context(&dp->dec_ctx);
 
     av_frame_free(&dp->frame);
+    av_frame_free(&dp->batch);
     av_packet_free(&dp->pkt);
 
     av_dict_free(&dp->standalone_init.opts);
@@ -256,6 +263,96 @@ static void audio_ts_process(DecoderPriv *dp, AVFrame *frame)
     frame->time_base = tb_filter;
 }
 
+static int audio_batch_flush(DecoderPriv *dp)
+{
+    int ret;
+
+    if (!dp->batch || !dp->batch->buf[0])
+        return 0;
+
+    ret = sch_dec_send(dp->sch, dp->sch_idx, dp->batch);
+    if (ret < 0) {
+        av_frame_unref(dp->batch);
+        return ret == AVERROR_EOF ? AVERROR_EXIT : ret;
+    }
+
+    return 0;
+}
+
+/**
+ * Append a decoded audio frame to the current batch, sending the batch
+ * downstream once it is full. This reduces the number of frames passed
+ * between threads for codecs with small frames.
+ */
+static int audio_batch_add(DecoderPriv *dp, AVFrame *frame)
+{
+    AVFrame *batch = dp->batch;
+    const int nb_samples = frame->nb_samples;
+    int ret;
+
+    // only contiguous frames with identical parameters can be merged; frames
+    // carrying side data start a new batch so that it is not lost
+    if (batch->buf[0] &&
+        (frame->format      != batch->format                                 ||
+         frame->sample_rate != batch->sample_rate                            ||
+         av_channel_layout_compare(&frame->ch_layout, &batch->ch_layout)     ||
+         frame->pts         != batch->pts + batch->nb_samples                ||
+         batch->nb_samples + nb_samples > dp->batch_size                     ||
+         frame->nb_side_data)) {
+        ret = audio_batch_flush(dp);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (!batch->buf[0]) {
+        const int size = av_rescale(dp->audio_batch, frame->sample_rate, AV_TIME_BASE);
+
+        if (nb_samples * 2 > size) {
+            ret = sch_dec_send(dp->sch, dp->sch_idx, frame);
+            if (ret < 0) {
+                av_frame_unref(frame);
+                return ret == AVERROR_EOF ? AVERROR_EXIT : ret;
+            }
+            return 0;
+        }
+
+        batch->format      = frame->format;
+        batch->sample_rate = frame->sample_rate;
+        batch->nb_samples  = size;
+        ret = av_channel_layout_copy(&batch->ch_layout, &frame->ch_layout);
+        if (ret < 0)
+            return ret;
+
+        ret = av_frame_get_buffer(batch, 0);
+        if (ret < 0)
+            return ret;
+
+        ret = av_frame_copy_props(batch, frame);
+        if (ret < 0)
+            return ret;
+
+        batch->nb_samples = 0;
+        batch->duration   = 0;
+        dp->batch_size    = size;
+    }
+
+    ret = av_samples_copy(batch->extended_data, frame->extended_data,
+                          batch->nb_samples, 0, nb_samples,
+                          frame->ch_layout.nb_channels, frame->format);
+    if (ret < 0)
+        return ret;
+    batch->nb_samples += nb_samples;
+    batch->duration   += nb_samples;
+
+    av_frame_unref(frame);
+
+    // send the batch as soon as another frame of the same size will not fit
+    if (batch->nb_samples + nb_samples > dp->batch_size)
+        return audio_batch_flush(dp);
+
+    return 0;
+}
+
 static int64_t video_duration_estimate(const DecoderPriv *dp, const AVFrame *frame)
 {
     const int  ts_unreliable = dp->flags & DECODER_FLAG_TS_UNRELIABLE;
@@ -710,7 +807,8 @@ static int packet_decode(DecoderPriv *dp, AVPacket *pkt, AVFrame *frame)
             av_assert0(pkt); // should never happen during flushing
             return 0;
         } else if (ret == AVERROR_EOF) {
-            return ret;
+            int err = audio_batch_flush(dp);
+            return err < 0 ? err : ret;
         } else if (ret < 0) {
             av_log(dp, AV_LOG_ERROR, "Decoding error: %s\n", av_err2str(ret));
             dp->dec.decode_errors++;
@@ -757,6 +855,13 @@ static int packet_decode(DecoderPriv *dp, AVPacket *pkt, AVFrame *frame)
 
         dp->dec.frames_decoded++;
 
+        if (dp->batch) {
+            ret = audio_batch_add(dp, frame);
+            if (ret < 0)
+                return ret;
+            continue;
+        }
+
         ret = sch_dec_send(dp->sch, dp->sch_idx, frame);
         if (ret < 0) {
             av_frame_unref(frame);
@@ -1147,6 +1252,13 @@ static int dec_open(DecoderPriv *dp, AVDictionary **dec_opts,
     dp->flags      = o->flags;
     dp->log_parent = o->log_parent;
 
+    if (codec->type == AVMEDIA_TYPE_AUDIO && o->audio_batch > 0) {
+        dp->audio_batch = o->audio_batch;
+        dp->batch       = av_frame_alloc();
+        if (!dp->batch)
+            return AVERROR(ENOMEM);
+    }
+
     dp->dec.type                = codec->type;
     dp->framerate_in            = o->framerate;
 
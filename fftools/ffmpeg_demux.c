@@ -124,6 +124,18 @@ typedef struct Demuxer {
     float                 readrate;
     double                readrate_initial_burst;
 
+    /* -keyframe_seek_interval, in AV_TIME_BASE units; 0 when disabled */
+    int64_t               kf_interval;
+    /* stream whose keyframes are extracted, NULL if not (yet) selected */
+    DemuxStream          *kf_ds;
+    /* next wanted timestamp and last forwarded keyframe, in kf_ds time base */
+    int64_t               kf_target;
+    int64_t               kf_last;
+    /* set when seeking failed and keyframes are filtered while reading */
+    int                   kf_sequential;
+    /* set when the index contains no further keyframes */
+    int                   kf_done;
+
     Scheduler            *sch;
 
     AVPacket             *pkt_heartbeat;
@@ -660,6 +672,131 @@ static void demux_thread_uninit(DemuxThreadContext *dt)
     memset(dt, 0, sizeof(*dt));
 }
 
+static void keyframe_seek_init(Demuxer *d)
+{
+    InputFile *f = &d->f;
+
+    for (int i = 0; i < f->nb_streams; i++) {
+        DemuxStream *ds = ds_from_ist(f->streams[i]);
+
+        if (ds->discard || ds->ist.par->codec_type != AVMEDIA_TYPE_VIDEO)
+            continue;
+
+        if (!d->kf_ds) {
+            d->kf_ds = ds;
+            continue;
+        }
+        av_log(d, AV_LOG_WARNING, "-keyframe_seek_interval only extracts "
+               "keyframes of stream #%d:%d, no packets will be read for "
+               "stream #%d:%d\n", f->index, d->kf_ds->ist.index,
+               f->index, ds->ist.index);
+    }
+
+    if (!d->kf_ds) {
+        av_log(d, AV_LOG_WARNING, "-keyframe_seek_interval given, but no video "
+               "stream is used from this input\n");
+        return;
+    }
+
+    d->kf_target = AV_NOPTS_VALUE;
+    d->kf_last   = AV_NOPTS_VALUE;
+}
+
+/**
+ * Seek to the keyframe closest to the next multiple of the interval after
+ * ts. The container index is used when available, so that only the
+ * keyframe packets themselves are read from the input.
+ */
+static int keyframe_seek_next(Demuxer *d, int64_t ts)
+{
+    AVFormatContext *ic = d->f.ctx;
+    AVStream        *st = d->kf_ds->ist.st;
+    int64_t    interval = FFMAX(av_rescale_q(d->kf_interval, AV_TIME_BASE_Q,
+                                             st->time_base), 1);
+    int ret;
+
+    /* the keyframe at ts may have been the nearest one to a target up to
+     * half an interval after it */
+    while (d->kf_target <= ts + interval / 2)
+        d->kf_target += interval;
+
+    if (d->kf_sequential)
+        return 0;
+
+    if (avformat_index_get_entries_count(st) > 0) {
+        const AVIndexEntry *prev, *next, *e;
+        int64_t seek_ts;
+
+        prev = avformat_index_get_entry_from_timestamp(st, d->kf_target,
+                                                       AVSEEK_FLAG_BACKWARD);
+        if (prev && prev->timestamp <= ts)
+            prev = NULL;
+        next = avformat_index_get_entry_from_timestamp(st, d->kf_target, 0);
+
+        /* some demuxers only fill the index while reading, so it may simply
+         * not extend this far yet; only stop if the demuxer cannot seek
+         * there either */
+        if (!prev && !next) {
+            ret = avformat_seek_file(ic, st->index, ts + 1, d->kf_target, INT64_MAX, 0);
+            if (ret < 0)
+                d->kf_done = 1;
+            return 0;
+        }
+
+        e = !prev ? next : !next ? prev :
+            d->kf_target - prev->timestamp <= next->timestamp - d->kf_target ?
+            prev : next;
+        seek_ts = e->timestamp;
+
+        ret = avformat_seek_file(ic, st->index, seek_ts, seek_ts, seek_ts, 0);
+        if (ret >= 0)
+            return 0;
+    }
+
+    ret = avformat_seek_file(ic, st->index, ts + 1, d->kf_target, INT64_MAX, 0);
+    if (ret < 0) {
+        av_log(d, AV_LOG_WARNING, "Could not seek to the next keyframe, "
+               "falling back to reading the whole input: %s\n", av_err2str(ret));
+        d->kf_sequential = 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Timestamp of a keyframe in -keyframe_seek_interval mode. The pts is
+ * preferred, as with B-frames the dts of a keyframe is earlier than its
+ * presentation time. Container indexes differ: Matroska cues store the pts,
+ * while mov/mp4 index by dts. A dts index entry is never later than the pts
+ * of its keyframe, so the entry of the current keyframe is not mistaken for
+ * a later one, and choosing between two neighbouring keyframes is off by at
+ * most the reordering delay.
+ */
+static int64_t keyframe_seek_ts(const AVPacket *pkt)
+{
+    return pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts;
+}
+
+/**
+ * Decide whether a packet read in -keyframe_seek_interval mode should be
+ * forwarded; only keyframes of the selected stream that have not been sent
+ * yet (and, without seeking, are not before the target) are.
+ */
+static int keyframe_seek_wanted(const Demuxer *d, const AVPacket *pkt)
+{
+    int64_t ts = keyframe_seek_ts(pkt);
+
+    if (pkt->stream_index != d->kf_ds->ist.index ||
+        !(pkt->flags & AV_PKT_FLAG_KEY) || ts == AV_NOPTS_VALUE)
+        return 0;
+    if (d->kf_last != AV_NOPTS_VALUE && ts <= d->kf_last)
+        return 0;
+    if (d->kf_sequential && ts < d->kf_target)
+        return 0;
+
+    return 1;
+}
+
 static int demux_thread_init(DemuxThreadContext *dt)
 {
     memset(dt, 0, sizeof(*dt));
@@ -692,14 +829,18 @@ static int input_thread(void *arg)
 
     discard_unused_programs(f);
 
+    if (d->kf_interval)
+        keyframe_seek_init(d);
+
     d->read_started    = 1;
     d->wallclock_start = av_gettime_relative();
 
     while (1) {
         DemuxStream *ds;
         unsigned send_flags = 0;
+        int64_t kf_ts = AV_NOPTS_VALUE;
 
-        ret = av_read_frame(f->ctx, dt.pkt_demux);
+        ret = d->kf_done ? AVERROR_EOF : av_read_frame(f->ctx, dt.pkt_demux);
 
         if (ret == AVERROR(EAGAIN)) {
             av_usleep(10000);
@@ -750,6 +891,14 @@ static int input_thread(void *arg)
             continue;
         }
 
+        if (d->kf_ds) {
+            if (!keyframe_seek_wanted(d, dt.pkt_demux)) {
+                av_packet_unref(dt.pkt_demux);
+                continue;
+            }
+            kf_ts = keyframe_seek_ts(dt.pkt_demux);
+        }
+
         if (dt.pkt_demux->flags & AV_PKT_FLAG_CORRUPT) {
             av_log(d, exit_on_error ? AV_LOG_FATAL : AV_LOG_WARNING,
                    "corrupt input packet in stream %d\n",
@@ -771,6 +920,16 @@ static int input_thread(void *arg)
         ret = demux_send(d, &dt, ds, dt.pkt_demux, send_flags);
         if (ret < 0)
             break;
+
+        if (kf_ts != AV_NOPTS_VALUE) {
+            if (d->kf_target == AV_NOPTS_VALUE)
+                d->kf_target = kf_ts;
+            d->kf_last = kf_ts;
+
+            ret = keyframe_seek_next(d, kf_ts);
+            if (ret < 0)
+                break;
+        }
     }
 
     // EOF/EXIT is normal termination
@@ -1384,6 +1543,7 @@ static int ist_add(const OptionsContext *o, Demuxer *d, AVStream *st)
     case AVMEDIA_TYPE_AUDIO: {
         int guess_layout_max = INT_MAX;
         MATCH_PER_STREAM_OPT(guess_layout_max, i, guess_layout_max, ic, st);
+        MATCH_PER_STREAM_OPT(audio_batch, i64, ds->dec_opts.audio_batch, ic, st);
         guess_input_channel_layout(ist, par, guess_layout_max);
         break;
     }
@@ -1799,6 +1959,17 @@ int ifile_open(const OptionsContext *o, const char *filename, Scheduler *sch)
                "since neither -readrate nor -re were given\n");
     }
 
+    if (o->keyframe_seek_interval < 0) {
+        av_log(d, AV_LOG_ERROR, "Option -keyframe_seek_interval must be non-negative.\n");
+        return AVERROR(EINVAL);
+    }
+    if (o->keyframe_seek_interval && d->loop) {
+        av_log(d, AV_LOG_WARNING, "Option -keyframe_seek_interval cannot be "
+               "combined with -stream_loop, looping disabled\n");
+        d->loop = 0;
+    }
+    d->kf_interval = o->keyframe_seek_interval;
+
     /* Add all the streams from the given input file to the demuxer */
     for (int i = 0; i < ic->nb_streams; i++) {
         ret = ist_add(o, d, ic->streams[i]);
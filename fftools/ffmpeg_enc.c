@@ -51,6 +51,11 @@ struct Encoder {
     int opened;
     int attach_par;
 
+    // encoder priming samples not yet signalled with skip samples side data
+    int64_t priming_left;
+    // encoder output samples, priming included, in the packets seen so far
+    int64_t samples_out;
+
     Scheduler      *sch;
     unsigned        sch_idx;
 };
@@ -341,6 +346,9 @@ int enc_open(void *opaque, const AVFrame *frame)
 
     e->opened = 1;
 
+    if (ost->trim_side_data)
+        e->priming_left = ost->enc_ctx->initial_padding;
+
     if (ost->enc_ctx->frame_size)
         frame_samples = ost->enc_ctx->frame_size;
 
@@ -634,6 +642,52 @@ static int update_video_stats(OutputStream *ost, const AVPacket *pkt, int write_
     return 0;
 }
 
+/*
+ * Signal the samples of the packet that are encoder priming or trailing
+ * padding rather than input, so that they can be trimmed without relying on
+ * the timestamps, e.g. when audio segments are encoded separately.
+ *
+ * Every packet holds frame_size samples of encoder output, so the padding
+ * follows from the number of samples sent to the encoder; the packet
+ * durations are rounded to the encoder time base and cannot be used.
+ */
+static int set_skip_samples(OutputStream *ost, AVPacket *pkt)
+{
+    Encoder          *e = ost->enc;
+    AVCodecContext *enc = ost->enc_ctx;
+    int64_t skip_start, skip_end;
+    uint8_t *sd;
+
+    if (av_packet_get_side_data(pkt, AV_PKT_DATA_SKIP_SAMPLES, NULL)) {
+        // the encoder signals it itself
+        e->priming_left = 0;
+        return 0;
+    }
+
+    if (!enc->frame_size || enc->codec->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE)
+        return 0;
+
+    skip_start = FFMIN(e->priming_left, enc->frame_size);
+    e->priming_left -= skip_start;
+    e->samples_out  += enc->frame_size;
+
+    /* all the frames before the last one are frame_size long, so only the
+     * packet holding the end of the input contains trailing padding */
+    skip_end = av_clip64(e->samples_out - enc->initial_padding - ost->samples_encoded,
+                         0, enc->frame_size - skip_start);
+
+    if (!skip_start && !skip_end)
+        return 0;
+
+    sd = av_packet_new_side_data(pkt, AV_PKT_DATA_SKIP_SAMPLES, 10);
+    if (!sd)
+        return AVERROR(ENOMEM);
+    AV_WL32(sd,     skip_start);
+    AV_WL32(sd + 4, skip_end);
+
+    return 0;
+}
+
 static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame,
                         AVPacket *pkt)
 {
@@ -726,6 +780,10 @@ static int encode_frame(OutputFile *of, OutputStream *ost, AVFrame *frame,
             ret = update_video_stats(ost, pkt, !!vstats_filename);
             if (ret < 0)
                 return ret;
+        } else if (enc->codec_type == AVMEDIA_TYPE_AUDIO && ost->trim_side_data) {
+            ret = set_skip_samples(ost, pkt);
+            if (ret < 0)
+                return ret;
         }
 
         if (ost->enc_stats_post.io)
@@ -148,6 +148,11 @@ typedef struct InputFilterPriv {
     struct {
         AVFrame *frame;
 
+        // canvases of pool_width x pool_height
+        AVBufferPool *pool;
+        int           pool_width;
+        int           pool_height;
+
         int64_t last_pts;
         int64_t end_pts;
 
@@ -241,24 +246,44 @@ static void filter_command_free(void *opaque, uint8_t *data)
     av_free(data);
 }
 
+/**
+ * Get a fully transparent canvas. Canvases are recycled through a pool to
+ * avoid a new allocation for every subtitle event. They are cleared in full,
+ * as filters may have written into a canvas in place once it was released.
+ */
 static int sub2video_get_blank_frame(InputFilterPriv *ifp)
 {
     AVFrame *frame = ifp->sub2video.frame;
-    int ret;
+    const int linesize = FFALIGN(ifp->width * 4, 64);
+    AVBufferRef *buf;
 
     av_frame_unref(frame);
 
-    frame->width  = ifp->width;
-    frame->height = ifp->height;
-    frame->format = ifp->format;
-    frame->colorspace = ifp->color_space;
-    frame->color_range = ifp->color_range;
+    if (!ifp->sub2video.pool ||
+        ifp->sub2video.pool_width  != ifp->width ||
+        ifp->sub2video.pool_height != ifp->height) {
+        av_buffer_pool_uninit(&ifp->sub2video.pool);
+        ifp->sub2video.pool = av_buffer_pool_init(linesize * ifp->height, NULL);
+        if (!ifp->sub2video.pool)
+            return AVERROR(ENOMEM);
+        ifp->sub2video.pool_width  = ifp->width;
+        ifp->sub2video.pool_height = ifp->height;
+    }
 
-    ret = av_frame_get_buffer(frame, 0);
-    if (ret < 0)
-        return ret;
+    buf = av_buffer_pool_get(ifp->sub2video.pool);
+    if (!buf)
+        return AVERROR(ENOMEM);
+
+    memset(buf->data, 0, linesize * ifp->height);
 
-    memset(frame->data[0], 0, frame->height * frame->linesize[0]);
+    frame->buf[0]      = buf;
+    frame->data[0]     = buf->data;
+    frame->linesize[0] = linesize;
+    frame->width       = ifp->width;
+    frame->height      = ifp->height;
+    frame->format      = ifp->format;
+    frame->colorspace  = ifp->color_space;
+    frame->color_range = ifp->color_range;
 
     return 0;
 }
@@ -909,6 +934,7 @@ void fg_free(FilterGraph **pfg)
             av_fifo_freep2(&ifp->frame_queue);
         }
         av_frame_free(&ifp->sub2video.frame);
+        av_buffer_pool_uninit(&ifp->sub2video.pool);
 
         av_frame_free(&ifp->frame);
         av_frame_free(&ifp->opts.fallback);
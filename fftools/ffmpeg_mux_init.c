@@ -861,6 +861,8 @@ static int new_stream_audio(Muxer *mux, const OptionsContext *o,
             if (!ost->apad)
                 return AVERROR(ENOMEM);
         }
+
+        MATCH_PER_STREAM_OPT(trim_side_data, i, ost->trim_side_data, oc, st);
     }
 
     return 0;
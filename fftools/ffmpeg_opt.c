@@ -1479,6 +1479,10 @@ const OptionDef options[] = {
     { "readrate_initial_burst", OPT_TYPE_DOUBLE, OPT_OFFSET | OPT_EXPERT | OPT_INPUT,
         { .off = OFFSET(readrate_initial_burst) },
         "The initial amount of input to burst read before imposing any readrate", "seconds" },
+    { "keyframe_seek_interval", OPT_TYPE_TIME, OPT_OFFSET | OPT_EXPERT | OPT_INPUT,
+        { .off = OFFSET(keyframe_seek_interval) },
+        "only read the video keyframes nearest to each multiple of the given interval, "
+        "seeking through the container index", "duration" },
     { "target",                 OPT_TYPE_FUNC, OPT_FUNC_ARG | OPT_PERFILE | OPT_EXPERT | OPT_OUTPUT,
         { .func_arg = opt_target },
         "specify target file type (\"vcd\", \"svcd\", \"dvd\", \"dv\" or \"dv50\" "
@@ -1507,6 +1511,9 @@ const OptionDef options[] = {
     { "apad",                   OPT_TYPE_STRING, OPT_PERSTREAM | OPT_EXPERT | OPT_OUTPUT,
         { .off = OFFSET(apad) },
         "audio pad", "" },
+    { "trim_side_data",         OPT_TYPE_BOOL, OPT_PERSTREAM | OPT_EXPERT | OPT_OUTPUT,
+        { .off = OFFSET(trim_side_data) },
+        "signal encoder priming and padding with skip samples side data" },
     { "dts_delta_threshold",    OPT_TYPE_FLOAT, OPT_EXPERT,
         { &dts_delta_threshold },
         "timestamp discontinuity delta threshold", "threshold" },
@@ -1793,6 +1800,9 @@ const OptionDef options[] = {
     { "guess_layout_max", OPT_TYPE_INT,     OPT_AUDIO | OPT_PERSTREAM | OPT_EXPERT | OPT_INPUT,
         { .off = OFFSET(guess_layout_max) },
       "set the maximum number of channels to try to guess the channel layout" },
+    { "audio_batch",      OPT_TYPE_TIME,    OPT_AUDIO | OPT_PERSTREAM | OPT_EXPERT | OPT_INPUT,
+        { .off = OFFSET(audio_batch) },
+      "merge decoded audio frames into frames of the given duration", "duration" },
 
     /* subtitle options */
     { "sn",     OPT_TYPE_BOOL, OPT_SUBTITLE | OPT_OFFSET | OPT_INPUT | OPT_OUTPUT,
@@ -30,6 +30,15 @@ typedef struct AACEncDSPContext {
     void (*quant_bands)(int *out, const float *in, const float *scaled,
                         int size, int is_signed, int maxval, const float Q34,
                         const float rounding);
+
+    /**
+     * Compute the energy (sum of squares) and the form factor (sum of
+     * square roots of the magnitudes) of one band of coefficients.
+     *
+     * @param size number of coefficients, must be a multiple of 4
+     */
+    void (*band_energy)(float *energy, float *form_factor,
+                        const float *coefs, int size);
 } AACEncDSPContext;
 
 void ff_aacenc_dsp_init_riscv(AACEncDSPContext *s);
@@ -57,10 +66,23 @@ static inline void quantize_bands(int *out, const float *in, const float *scaled
     }
 }
 
+static inline void band_energy(float *energy, float *form_factor,
+                               const float *coefs, int size)
+{
+    float e = 0.0f, ff = 0.0f;
+    for (int i = 0; i < size; i++) {
+        e  += coefs[i] * coefs[i];
+        ff += sqrtf(fabsf(coefs[i]));
+    }
+    *energy      = e;
+    *form_factor = ff;
+}
+
 static inline void ff_aacenc_dsp_init(AACEncDSPContext *s)
 {
     s->abs_pow34   = abs_pow34_v;
     s->quant_bands = quantize_bands;
+    s->band_energy = band_energy;
 
 #if ARCH_RISCV
     ff_aacenc_dsp_init_riscv(s);
@@ -214,13 +214,24 @@ static av_cold int ac3_decode_init(AVCodecContext *avctx)
 
     s->avctx = avctx;
 
-    if ((ret = av_tx_init(&s->tx_128, &s->tx_fn_128, IMDCT_TYPE, 1, 128, &scale, 0)))
+    /* in analysis mode, only the lowest quarter of the spectrum is
+       synthesized, with transforms a quarter of the normal size */
+    if (s->analysis) {
+        s->block_shift = 2;
+        if (!s->downmix_layout.nb_channels)
+            s->downmix_layout = (AVChannelLayout)AV_CHANNEL_LAYOUT_MONO;
+    }
+    s->block_size = AC3_BLOCK_SIZE >> s->block_shift;
+
+    if ((ret = av_tx_init(&s->tx_128, &s->tx_fn_128, IMDCT_TYPE, 1,
+                          s->block_size / 2, &scale, 0)))
         return ret;
 
-    if ((ret = av_tx_init(&s->tx_256, &s->tx_fn_256, IMDCT_TYPE, 1, 256, &scale, 0)))
+    if ((ret = av_tx_init(&s->tx_256, &s->tx_fn_256, IMDCT_TYPE, 1,
+                          s->block_size, &scale, 0)))
         return ret;
 
-    AC3_RENAME(ff_kbd_window_init)(s->window, 5.0, 256);
+    AC3_RENAME(ff_kbd_window_init)(s->window, 5.0, s->block_size);
     ff_bswapdsp_init(&s->bdsp);
 
 #if (USE_FIXED)
@@ -439,6 +450,23 @@ static int set_downmix_coeffs(AC3DecodeContext *s)
             downmix_coeffs[0][i] = (downmix_coeffs[0][i] +
                                     downmix_coeffs[1][i]) * LEVEL_MINUS_3DB;
     }
+
+    /* a caller-provided matrix replaces the coefficients from the bitstream */
+    if (s->nb_downmix_matrix) {
+        if (s->nb_downmix_matrix == s->out_channels * s->fbw_channels) {
+            for (i = 0; i < s->fbw_channels; i++) {
+                downmix_coeffs[0][i] = s->downmix_matrix[i];
+                if (s->out_channels > 1)
+                    downmix_coeffs[1][i] = s->downmix_matrix[s->fbw_channels + i];
+            }
+        } else {
+            av_log(s->avctx, AV_LOG_WARNING, "downmix_matrix has %u coefficients, "
+                   "%d expected for %d to %d channels, ignoring it\n",
+                   s->nb_downmix_matrix, s->out_channels * s->fbw_channels,
+                   s->fbw_channels, s->out_channels);
+        }
+    }
+
     for (i = 0; i < s->fbw_channels; i++) {
         s->downmix_coeffs[0][i] = FIXR12(downmix_coeffs[0][i]);
         s->downmix_coeffs[1][i] = FIXR12(downmix_coeffs[1][i]);
@@ -712,35 +740,36 @@ static void do_rematrixing(AC3DecodeContext *s)
  */
 static inline void do_imdct(AC3DecodeContext *s, int channels, int offset)
 {
+    const int half = s->block_size / 2;
     int ch;
 
     for (ch = 1; ch <= channels; ch++) {
         if (s->block_switch[ch]) {
             int i;
-            INTFLOAT *x = s->tmp_output + 128;
-            for (i = 0; i < 128; i++)
+            INTFLOAT *x = s->tmp_output + half;
+            for (i = 0; i < half; i++)
                 x[i] = s->transform_coeffs[ch][2 * i];
             s->tx_fn_128(s->tx_128, s->tmp_output, x, sizeof(INTFLOAT));
 #if USE_FIXED
             s->fdsp->vector_fmul_window_scaled(s->outptr[ch - 1], s->delay[ch - 1 + offset],
-                                       s->tmp_output, s->window, 128, 8);
+                                       s->tmp_output, s->window, half, 8);
 #else
             s->fdsp->vector_fmul_window(s->outptr[ch - 1], s->delay[ch - 1 + offset],
-                                       s->tmp_output, s->window, 128);
+                                       s->tmp_output, s->window, half);
 #endif
-            for (i = 0; i < 128; i++)
+            for (i = 0; i < half; i++)
                 x[i] = s->transform_coeffs[ch][2 * i + 1];
             s->tx_fn_128(s->tx_128, s->delay[ch - 1 + offset], x, sizeof(INTFLOAT));
         } else {
             s->tx_fn_256(s->tx_256, s->tmp_output, s->transform_coeffs[ch], sizeof(INTFLOAT));
 #if USE_FIXED
             s->fdsp->vector_fmul_window_scaled(s->outptr[ch - 1], s->delay[ch - 1 + offset],
-                                       s->tmp_output, s->window, 128, 8);
+                                       s->tmp_output, s->window, half, 8);
 #else
             s->fdsp->vector_fmul_window(s->outptr[ch - 1], s->delay[ch - 1 + offset],
-                                       s->tmp_output, s->window, 128);
+                                       s->tmp_output, s->window, half);
 #endif
-            memcpy(s->delay[ch - 1 + offset], s->tmp_output + 128, 128 * sizeof(INTFLOAT));
+            memcpy(s->delay[ch - 1 + offset], s->tmp_output + half, half * sizeof(INTFLOAT));
         }
     }
 }
@@ -1424,13 +1453,13 @@ static int decode_audio_block(AC3DecodeContext *s, int blk, int offset)
             gain = s->dynamic_range[audio_channel];
 
 #if USE_FIXED
-        scale_coefs(s->transform_coeffs[ch], s->fixed_coeffs[ch], gain, 256);
+        scale_coefs(s->transform_coeffs[ch], s->fixed_coeffs[ch], gain, s->block_size);
 #else
         if (s->target_level != 0)
           gain = gain * s->level_gain[audio_channel];
         gain *= 1.0 / 4194304.0f;
         s->fmt_conv.int32_to_float_fmul_scalar(s->transform_coeffs[ch],
-                                               s->fixed_coeffs[ch], gain, 256);
+                                               s->fixed_coeffs[ch], gain, s->block_size);
 #endif
     }
 
@@ -1458,22 +1487,22 @@ static int decode_audio_block(AC3DecodeContext *s, int blk, int offset)
         if (downmix_output) {
 #if USE_FIXED
             ac3_downmix_c_fixed16(s->outptr, s->downmix_coeffs,
-                              s->out_channels, s->fbw_channels, 256);
+                              s->out_channels, s->fbw_channels, s->block_size);
 #else
             ff_ac3dsp_downmix(&s->ac3dsp, s->outptr, s->downmix_coeffs,
-                              s->out_channels, s->fbw_channels, 256);
+                              s->out_channels, s->fbw_channels, s->block_size);
 #endif
         }
     } else {
         if (downmix_output) {
             AC3_RENAME(ff_ac3dsp_downmix)(&s->ac3dsp, s->xcfptr + 1, s->downmix_coeffs,
-                                          s->out_channels, s->fbw_channels, 256);
+                                          s->out_channels, s->fbw_channels, s->block_size);
         }
 
         if (downmix_output && !s->downmixed) {
             s->downmixed = 1;
             AC3_RENAME(ff_ac3dsp_downmix)(&s->ac3dsp, s->dlyptr, s->downmix_coeffs,
-                                          s->out_channels, s->fbw_channels, 128);
+                                          s->out_channels, s->fbw_channels, s->block_size / 2);
         }
 
         do_imdct(s, s->out_channels, offset);
@@ -1655,18 +1684,18 @@ dependent_frame:
         }
         if (err)
             for (ch = 0; ch < s->out_channels; ch++)
-                memcpy(s->output_buffer[ch + offset] + AC3_BLOCK_SIZE*blk, output[ch], AC3_BLOCK_SIZE*sizeof(SHORTFLOAT));
+                memcpy(s->output_buffer[ch + offset] + s->block_size*blk, output[ch], s->block_size*sizeof(SHORTFLOAT));
         for (ch = 0; ch < s->out_channels; ch++)
             output[ch] = s->outptr[channel_map[ch]];
         for (ch = 0; ch < s->out_channels; ch++) {
             if (!ch || channel_map[ch])
-                s->outptr[channel_map[ch]] += AC3_BLOCK_SIZE;
+                s->outptr[channel_map[ch]] += s->block_size;
         }
     }
 
     /* keep last block for error concealment in next frame */
     for (ch = 0; ch < s->out_channels; ch++)
-        memcpy(s->output[ch + offset], output[ch], AC3_BLOCK_SIZE*sizeof(SHORTFLOAT));
+        memcpy(s->output[ch + offset], output[ch], s->block_size*sizeof(SHORTFLOAT));
 
     /* check if there is dependent frame */
     if (buf_size > s->frame_size) {
@@ -1704,7 +1733,7 @@ skip:
 
     /* if frame is ok, set audio parameters */
     if (!err) {
-        avctx->sample_rate = s->sample_rate;
+        avctx->sample_rate = s->sample_rate >> s->block_shift;
         avctx->bit_rate    = s->bit_rate + s->prev_bit_rate;
         avctx->profile     = s->eac3_extension_type_a == 1 ? AV_PROFILE_EAC3_DDP_ATMOS : AV_PROFILE_UNKNOWN;
     }
@@ -1774,7 +1803,7 @@ skip:
     }
 
     /* get output buffer */
-    frame->nb_samples = s->num_blocks * AC3_BLOCK_SIZE;
+    frame->nb_samples = s->num_blocks * s->block_size;
     if ((ret = ff_get_buffer(avctx, frame, 0)) < 0)
         return ret;
 
@@ -1783,7 +1812,7 @@ skip:
         av_assert0(ch>=AV_NUM_DATA_POINTERS || frame->extended_data[ch] == frame->data[ch]);
         memcpy((SHORTFLOAT *)frame->extended_data[ch],
                s->output_buffer[map],
-               s->num_blocks * AC3_BLOCK_SIZE * sizeof(SHORTFLOAT));
+               s->num_blocks * s->block_size * sizeof(SHORTFLOAT));
     }
 
     /*
@@ -224,6 +224,8 @@ typedef struct AC3DecodeContext {
     int block_switch[AC3_MAX_CHANNELS];     ///< block switch flags                     (blksw)
     AVTXContext *tx_128, *tx_256;
     av_tx_fn tx_fn_128, tx_fn_256;
+    int block_shift;                        ///< log2 of the output decimation factor
+    int block_size;                         ///< output samples per block
 ///@}
 
 ///@name Optimization
@@ -253,6 +255,9 @@ typedef struct AC3DecodeContext {
 ///@}
 
     AVChannelLayout downmix_layout;
+    float *downmix_matrix;                      ///< caller-provided downmix coefficients
+    unsigned nb_downmix_matrix;
+    int analysis;                               ///< decode a reduced signal for analysis
 } AC3DecodeContext;
 
 /**
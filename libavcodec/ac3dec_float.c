@@ -50,6 +50,8 @@ static const AVOption options[] = {
 {"loro_surmixlev", "Lo/Ro Surround Mix Level", OFFSET(loro_surround_mix_level),  AV_OPT_TYPE_FLOAT, {.dbl = -1.0 }, -1.0, 2.0, 0},
 
     { "downmix", "Request a specific channel layout from the decoder", OFFSET(downmix_layout), AV_OPT_TYPE_CHLAYOUT, {.str = NULL}, .flags = PAR },
+    { "downmix_matrix", "Downmix coefficients replacing the ones from the bitstream", OFFSET(downmix_matrix), AV_OPT_TYPE_FLOAT | AV_OPT_TYPE_FLAG_ARRAY, .min = -4.0, .max = 4.0, .flags = PAR },
+    { "analysis", "decode a downmixed signal at a quarter of the sample rate", OFFSET(analysis), AV_OPT_TYPE_BOOL, {.i64 = 0 }, 0, 1, PAR },
 
     { NULL},
 };
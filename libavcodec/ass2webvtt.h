@@ -0,0 +1,55 @@
+/*
+ * ASS to WebVTT cue text conversion
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_ASS2WEBVTT_H
+#define AVCODEC_ASS2WEBVTT_H
+
+#include "libavutil/bprint.h"
+#include "ass_split.h"
+
+#define FF_ASS2WEBVTT_STACK_SIZE 64
+
+typedef struct FFASS2WebVTTContext {
+    void *log_ctx;
+    /**
+     * Styles used to resolve the Style field and {\r} overrides;
+     * may be NULL, in which case no style is applied.
+     */
+    ASSSplitContext *ass_ctx;
+    /**
+     * Destination of the WebVTT cue text.
+     */
+    AVBPrint *buffer;
+    char stack[FF_ASS2WEBVTT_STACK_SIZE];
+    int stack_ptr;
+} FFASS2WebVTTContext;
+
+/**
+ * Append the WebVTT cue text for one ASS event to s->buffer.
+ * Conversion stops at a malformed override block, keeping the text
+ * converted so far.
+ *
+ * @param style name of the event style, NULL or empty for "Default"
+ * @param text  the ASS "Dialogue" Text field
+ */
+void ff_ass2webvtt_event(FFASS2WebVTTContext *s, const char *style,
+                         const char *text);
+
+#endif /* AVCODEC_ASS2WEBVTT_H */
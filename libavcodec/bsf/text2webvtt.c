@@ -0,0 +1,185 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Text subtitles to WebVTT bitstream filter.
+ *
+ * Produces the same cue text as decoding and re-encoding with the webvtt
+ * encoder, but works on the packets directly: no AVSubtitle is built, no
+ * ASS Dialogue line is printed and ASS events are not split into
+ * separately allocated fields.
+ */
+
+#include "libavutil/bprint.h"
+#include "libavutil/mem.h"
+#include "bsf.h"
+#include "bsf_internal.h"
+#include "ass.h"
+#include "ass2webvtt.h"
+#include "ass_split.h"
+#include "htmlsubtitles.h"
+
+typedef struct Text2WebVTTContext {
+    ASSSplitContext *ass_ctx;
+    FFASS2WebVTTContext conv;
+    AVBPrint text;  ///< ASS Text field, for codecs that need converting to ASS
+    AVBPrint style; ///< Style field of the current ASS event
+    AVBPrint out;
+} Text2WebVTTContext;
+
+static av_cold int text2webvtt_init(AVBSFContext *ctx)
+{
+    Text2WebVTTContext *s = ctx->priv_data;
+
+    if (ctx->par_in->codec_id == AV_CODEC_ID_ASS && ctx->par_in->extradata_size) {
+        /* extradata is zero-padded, so it can be parsed as a string */
+        s->ass_ctx = ff_ass_split(ctx->par_in->extradata);
+        if (!s->ass_ctx)
+            return AVERROR_INVALIDDATA;
+    }
+
+    av_bprint_init(&s->text,  0, AV_BPRINT_SIZE_UNLIMITED);
+    av_bprint_init(&s->style, 0, AV_BPRINT_SIZE_UNLIMITED);
+    av_bprint_init(&s->out,   0, AV_BPRINT_SIZE_UNLIMITED);
+    s->conv.log_ctx = ctx;
+    s->conv.ass_ctx = s->ass_ctx;
+    s->conv.buffer  = &s->out;
+
+    ctx->par_out->codec_id = AV_CODEC_ID_WEBVTT;
+    av_freep(&ctx->par_out->extradata);
+    ctx->par_out->extradata_size = 0;
+
+    return 0;
+}
+
+/**
+ * Convert an ASS packet ("ReadOrder,Layer,Style,Name,MarginL,MarginR,
+ * MarginV,Effect,Text"), parsing its fields in place.
+ */
+static int convert_ass(Text2WebVTTContext *s, const char *p)
+{
+    for (int i = 0; i < 8; i++) {
+        size_t len;
+
+        while (*p == ' ')
+            p++;
+        len = strcspn(p, ",");
+        if (i == 2) {
+            av_bprint_clear(&s->style);
+            av_bprint_append_data(&s->style, p, len);
+            if (!av_bprint_is_complete(&s->style))
+                return AVERROR(ENOMEM);
+        }
+        p += len;
+        if (*p)
+            p++;
+    }
+    while (*p == ' ')
+        p++;
+
+    ff_ass2webvtt_event(&s->conv, s->style.str, p);
+    return 0;
+}
+
+static int text2webvtt_filter(AVBSFContext *ctx, AVPacket *out)
+{
+    Text2WebVTTContext *s = ctx->priv_data;
+    AVPacket *in;
+    int ret;
+
+    ret = ff_bsf_get_packet(ctx, &in);
+    if (ret < 0)
+        return ret;
+
+    /* empty packets do not produce an event in the decoders either */
+    if (in->size <= 0) {
+        ret = AVERROR(EAGAIN);
+        goto fail;
+    }
+
+    av_bprint_clear(&s->out);
+
+    /* packet data is zero-padded, so it can be read as a string, as the
+     * decoders do */
+    switch (ctx->par_in->codec_id) {
+    case AV_CODEC_ID_ASS:
+        ret = convert_ass(s, in->data);
+        break;
+    case AV_CODEC_ID_SUBRIP:
+        av_bprint_clear(&s->text);
+        ret = ff_htmlmarkup_to_ass(ctx, &s->text, in->data);
+        if (ret >= 0)
+            ff_ass2webvtt_event(&s->conv, NULL, s->text.str);
+        break;
+    case AV_CODEC_ID_TEXT:
+        av_bprint_clear(&s->text);
+        ff_ass_bprint_text_event(&s->text, in->data, in->size, NULL, 0);
+        if (!av_bprint_is_complete(&s->text))
+            ret = AVERROR(ENOMEM);
+        else
+            ff_ass2webvtt_event(&s->conv, NULL, s->text.str);
+        break;
+    }
+    if (ret < 0)
+        goto fail;
+
+    if (!av_bprint_is_complete(&s->out)) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    ret = av_new_packet(out, s->out.len);
+    if (ret < 0)
+        goto fail;
+
+    ret = av_packet_copy_props(out, in);
+    if (ret < 0)
+        goto fail;
+
+    memcpy(out->data, s->out.str, s->out.len);
+
+fail:
+    if (ret < 0)
+        av_packet_unref(out);
+    av_packet_free(&in);
+    return ret;
+}
+
+static av_cold void text2webvtt_close(AVBSFContext *ctx)
+{
+    Text2WebVTTContext *s = ctx->priv_data;
+
+    ff_ass_split_free(s->ass_ctx);
+    av_bprint_finalize(&s->text,  NULL);
+    av_bprint_finalize(&s->style, NULL);
+    av_bprint_finalize(&s->out,   NULL);
+}
+
+static const enum AVCodecID text2webvtt_codec_ids[] = {
+    AV_CODEC_ID_ASS, AV_CODEC_ID_SUBRIP, AV_CODEC_ID_TEXT, AV_CODEC_ID_NONE,
+};
+
+const FFBitStreamFilter ff_text2webvtt_bsf = {
+    .p.name         = "text2webvtt",
+    .p.codec_ids    = text2webvtt_codec_ids,
+    .priv_data_size = sizeof(Text2WebVTTContext),
+    .init           = text2webvtt_init,
+    .filter         = text2webvtt_filter,
+    .close          = text2webvtt_close,
+};
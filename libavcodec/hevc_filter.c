@@ -24,6 +24,8 @@
 
 #include "libavutil/common.h"
 #include "libavutil/internal.h"
+#include "libavutil/mem.h"
+#include "libavutil/thread.h"
 
 #include "hevcdec.h"
 #include "threadframe.h"
@@ -848,20 +850,22 @@ void ff_hevc_deblocking_boundary_strengths(HEVCLocalContext *lc, int x0, int y0,
 #undef CB
 #undef CR
 
-void ff_hevc_hls_filter(HEVCLocalContext *lc, int x, int y, int ctb_size)
+static int loop_filter_skipped(const HEVCContext *s)
+{
+    return s->avctx->skip_loop_filter >= AVDISCARD_ALL ||
+           (s->avctx->skip_loop_filter >= AVDISCARD_NONKEY && !IS_IDR(s)) ||
+           (s->avctx->skip_loop_filter >= AVDISCARD_NONINTRA &&
+            s->sh.slice_type != HEVC_SLICE_I) ||
+           (s->avctx->skip_loop_filter >= AVDISCARD_BIDIR &&
+            s->sh.slice_type == HEVC_SLICE_B) ||
+           (s->avctx->skip_loop_filter >= AVDISCARD_NONREF &&
+            ff_hevc_nal_is_nonref(s->nal_unit_type));
+}
+
+static void hls_filter(HEVCLocalContext *lc, int x, int y, int ctb_size, int skip)
 {
     const HEVCContext *const s = lc->parent;
     int x_end = x >= s->ps.sps->width  - ctb_size;
-    int skip = 0;
-    if (s->avctx->skip_loop_filter >= AVDISCARD_ALL ||
-        (s->avctx->skip_loop_filter >= AVDISCARD_NONKEY && !IS_IDR(s)) ||
-        (s->avctx->skip_loop_filter >= AVDISCARD_NONINTRA &&
-         s->sh.slice_type != HEVC_SLICE_I) ||
-        (s->avctx->skip_loop_filter >= AVDISCARD_BIDIR &&
-         s->sh.slice_type == HEVC_SLICE_B) ||
-        (s->avctx->skip_loop_filter >= AVDISCARD_NONREF &&
-        ff_hevc_nal_is_nonref(s->nal_unit_type)))
-        skip = 1;
 
     if (!skip)
         deblocking_filter_CTB(s, x, y);
@@ -885,14 +889,260 @@ void ff_hevc_hls_filter(HEVCLocalContext *lc, int x, int y, int ctb_size)
         ff_thread_report_progress(&s->ref->tf, y + ctb_size - 4, 0);
 }
 
-void ff_hevc_hls_filters(HEVCLocalContext *lc, int x_ctb, int y_ctb, int ctb_size)
+void ff_hevc_hls_filter(HEVCLocalContext *lc, int x, int y, int ctb_size)
+{
+    hls_filter(lc, x, y, ctb_size, loop_filter_skipped(lc->parent));
+}
+
+static void hls_filters(HEVCLocalContext *lc, int x_ctb, int y_ctb,
+                        int ctb_size, int skip)
 {
     int x_end = x_ctb >= lc->parent->ps.sps->width  - ctb_size;
     int y_end = y_ctb >= lc->parent->ps.sps->height - ctb_size;
     if (y_ctb && x_ctb)
-        ff_hevc_hls_filter(lc, x_ctb - ctb_size, y_ctb - ctb_size, ctb_size);
+        hls_filter(lc, x_ctb - ctb_size, y_ctb - ctb_size, ctb_size, skip);
     if (y_ctb && x_end)
-        ff_hevc_hls_filter(lc, x_ctb, y_ctb - ctb_size, ctb_size);
+        hls_filter(lc, x_ctb, y_ctb - ctb_size, ctb_size, skip);
     if (x_ctb && y_end)
-        ff_hevc_hls_filter(lc, x_ctb - ctb_size, y_ctb, ctb_size);
+        hls_filter(lc, x_ctb - ctb_size, y_ctb, ctb_size, skip);
+}
+
+void ff_hevc_hls_filters(HEVCLocalContext *lc, int x_ctb, int y_ctb, int ctb_size)
+{
+    hls_filters(lc, x_ctb, y_ctb, ctb_size, loop_filter_skipped(lc->parent));
+}
+
+#if HAVE_THREADS
+
+#define CTB_DECODED     1
+#define CTB_FILTER_SKIP 2
+
+/**
+ * Deferred in-loop filtering state.
+ *
+ * The decoding thread marks CTBs as decoded in raster order and publishes
+ * them once per CTB row. The helper thread then replays the filter calls the
+ * decoding thread would have made, so the filter keeps its usual lag of one
+ * CTB row and column behind reconstruction.
+ */
+typedef struct HEVCFilterThread {
+    HEVCContext *s;
+    HEVCLocalContext *lc;
+
+    uint8_t *ctb_flags;
+    unsigned int ctb_flags_size;
+
+    int pending;            ///< CTBs marked by the decoder, not yet published
+    int published;          ///< CTBs the filter thread may process
+    int filtered;           ///< CTBs the filter thread has processed
+    int exit;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+} HEVCFilterThread;
+
+static void filter_ctbs(HEVCFilterThread *ft, int start, int end)
+{
+    const HEVCContext *s = ft->s;
+    int log2_ctb_size    = s->ps.sps->log2_ctb_size;
+    int ctb_size         = 1 << log2_ctb_size;
+    int ctb_width        = s->ps.sps->ctb_width;
+
+    for (int rs = start; rs < end; rs++) {
+        int x_ctb = (rs % ctb_width) << log2_ctb_size;
+        int y_ctb = (rs / ctb_width) << log2_ctb_size;
+        int skip  = !!(ft->ctb_flags[rs] & CTB_FILTER_SKIP);
+
+        if (!(ft->ctb_flags[rs] & CTB_DECODED))
+            continue;
+
+        hls_filters(ft->lc, x_ctb, y_ctb, ctb_size, skip);
+        if (x_ctb + ctb_size >= s->ps.sps->width &&
+            y_ctb + ctb_size >= s->ps.sps->height)
+            hls_filter(ft->lc, x_ctb, y_ctb, ctb_size, skip);
+    }
+}
+
+static void *filter_thread(void *arg)
+{
+    HEVCFilterThread *ft = arg;
+
+    pthread_mutex_lock(&ft->mutex);
+    while (!ft->exit) {
+        int start = ft->filtered, end = ft->published;
+
+        if (start >= end) {
+            pthread_cond_wait(&ft->work_cond, &ft->mutex);
+            continue;
+        }
+        pthread_mutex_unlock(&ft->mutex);
+
+        filter_ctbs(ft, start, end);
+
+        pthread_mutex_lock(&ft->mutex);
+        ft->filtered = end;
+        pthread_cond_broadcast(&ft->done_cond);
+    }
+    pthread_mutex_unlock(&ft->mutex);
+
+    return NULL;
 }
+
+int ff_hevc_filter_thread_init(HEVCContext *s)
+{
+    HEVCFilterThread *ft;
+    int ret;
+
+    ft = av_mallocz(sizeof(*ft));
+    if (!ft)
+        return AVERROR(ENOMEM);
+
+    ft->s  = s;
+    ft->lc = av_mallocz(sizeof(*ft->lc));
+    if (!ft->lc) {
+        av_free(ft);
+        return AVERROR(ENOMEM);
+    }
+    ft->lc->parent = s;
+    ft->lc->logctx = s->avctx;
+
+    if ((ret = pthread_mutex_init(&ft->mutex, NULL))) {
+        ret = AVERROR(ret);
+        goto fail_mutex;
+    }
+    if ((ret = pthread_cond_init(&ft->work_cond, NULL))) {
+        ret = AVERROR(ret);
+        goto fail_work_cond;
+    }
+    if ((ret = pthread_cond_init(&ft->done_cond, NULL))) {
+        ret = AVERROR(ret);
+        goto fail_done_cond;
+    }
+    if ((ret = pthread_create(&ft->thread, NULL, filter_thread, ft))) {
+        ret = AVERROR(ret);
+        goto fail_thread;
+    }
+
+    s->filter_thread = ft;
+    return 0;
+
+fail_thread:
+    pthread_cond_destroy(&ft->done_cond);
+fail_done_cond:
+    pthread_cond_destroy(&ft->work_cond);
+fail_work_cond:
+    pthread_mutex_destroy(&ft->mutex);
+fail_mutex:
+    av_free(ft->lc);
+    av_free(ft);
+    return ret;
+}
+
+void ff_hevc_filter_thread_free(HEVCContext *s)
+{
+    HEVCFilterThread *ft = s->filter_thread;
+
+    if (!ft)
+        return;
+
+    pthread_mutex_lock(&ft->mutex);
+    ft->exit = 1;
+    pthread_cond_signal(&ft->work_cond);
+    pthread_mutex_unlock(&ft->mutex);
+    pthread_join(ft->thread, NULL);
+
+    pthread_cond_destroy(&ft->done_cond);
+    pthread_cond_destroy(&ft->work_cond);
+    pthread_mutex_destroy(&ft->mutex);
+
+    av_freep(&ft->ctb_flags);
+    av_freep(&ft->lc);
+    av_freep(&s->filter_thread);
+}
+
+static void publish(HEVCFilterThread *ft)
+{
+    pthread_mutex_lock(&ft->mutex);
+    ft->published = ft->pending;
+    pthread_cond_signal(&ft->work_cond);
+    pthread_mutex_unlock(&ft->mutex);
+}
+
+void ff_hevc_filter_thread_wait(HEVCContext *s)
+{
+    HEVCFilterThread *ft = s->filter_thread;
+
+    if (!ft)
+        return;
+
+    if (ft->pending > ft->published)
+        publish(ft);
+
+    pthread_mutex_lock(&ft->mutex);
+    while (ft->filtered < ft->published)
+        pthread_cond_wait(&ft->done_cond, &ft->mutex);
+    pthread_mutex_unlock(&ft->mutex);
+}
+
+int ff_hevc_filter_thread_start_frame(HEVCContext *s)
+{
+    HEVCFilterThread *ft = s->filter_thread;
+    int nb_ctbs;
+
+    if (!ft)
+        return 0;
+
+    ff_hevc_filter_thread_wait(s);
+
+    nb_ctbs = s->ps.sps->ctb_width * s->ps.sps->ctb_height;
+    av_fast_malloc(&ft->ctb_flags, &ft->ctb_flags_size, nb_ctbs);
+    if (!ft->ctb_flags)
+        return AVERROR(ENOMEM);
+    memset(ft->ctb_flags, 0, nb_ctbs);
+
+    ft->pending   = 0;
+    ft->published = 0;
+    ft->filtered  = 0;
+
+    return 0;
+}
+
+void ff_hevc_filter_thread_queue(HEVCContext *s, int ctb_addr_rs)
+{
+    HEVCFilterThread *ft = s->filter_thread;
+
+    ft->ctb_flags[ctb_addr_rs] = CTB_DECODED |
+                                 (loop_filter_skipped(s) ? CTB_FILTER_SKIP : 0);
+    ft->pending = FFMAX(ft->pending, ctb_addr_rs + 1);
+
+    if ((ctb_addr_rs + 1) % s->ps.sps->ctb_width == 0)
+        publish(ft);
+}
+
+#else
+
+int ff_hevc_filter_thread_init(HEVCContext *s)
+{
+    return 0;
+}
+
+void ff_hevc_filter_thread_free(HEVCContext *s)
+{
+}
+
+void ff_hevc_filter_thread_wait(HEVCContext *s)
+{
+}
+
+int ff_hevc_filter_thread_start_frame(HEVCContext *s)
+{
+    return 0;
+}
+
+void ff_hevc_filter_thread_queue(HEVCContext *s, int ctb_addr_rs)
+{
+}
+
+#endif /* HAVE_THREADS */
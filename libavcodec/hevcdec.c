@@ -2535,6 +2535,7 @@ static int hls_decode_entry(AVCodecContext *avctxt, void *arg)
     int x_ctb       = 0;
     int y_ctb       = 0;
     int ctb_addr_ts = s->ps.pps->ctb_addr_rs_to_ts[s->sh.slice_ctb_addr_rs];
+    int deferred    = s->filter_thread && !s->ps.pps->tiles_enabled_flag;
     int ret;
 
     if (!ctb_addr_ts && s->sh.dependent_slice_segment_flag) {
@@ -2578,10 +2579,14 @@ static int hls_decode_entry(AVCodecContext *avctxt, void *arg)
 
         ctb_addr_ts++;
         ff_hevc_save_states(lc, ctb_addr_ts);
-        ff_hevc_hls_filters(lc, x_ctb, y_ctb, ctb_size);
+        if (deferred)
+            ff_hevc_filter_thread_queue(s, ctb_addr_rs);
+        else
+            ff_hevc_hls_filters(lc, x_ctb, y_ctb, ctb_size);
     }
 
-    if (x_ctb + ctb_size >= s->ps.sps->width &&
+    if (!deferred &&
+        x_ctb + ctb_size >= s->ps.sps->width &&
         y_ctb + ctb_size >= s->ps.sps->height)
         ff_hevc_hls_filter(lc, x_ctb, y_ctb, ctb_size);
 
@@ -2873,6 +2878,10 @@ static int hevc_frame_start(HEVCContext *s)
     if (s->ps.pps->tiles_enabled_flag)
         lc->end_of_tiles_x = s->ps.pps->column_width[0] << s->ps.sps->log2_ctb_size;
 
+    ret = ff_hevc_filter_thread_start_frame(s);
+    if (ret < 0)
+        goto fail;
+
     ret = ff_hevc_set_new_ref(s, &s->frame, s->poc);
     if (ret < 0)
         goto fail;
@@ -2970,6 +2979,15 @@ static int decode_nal_unit(HEVCContext *s, const H2645NAL *nal)
     GetBitContext *gb    = &lc->gb;
     int ctb_addr_ts, ret;
 
+    /* Only further slices of the current picture may overlap with deferred
+     * loop filtering; anything else may replace the parameter sets or the
+     * per-picture tables the filter thread reads. */
+    if (s->filter_thread) {
+        GetBitContext first_slice_gb = nal->gb;
+        if (nal->type > HEVC_NAL_CRA_NUT || get_bits1(&first_slice_gb))
+            ff_hevc_filter_thread_wait(s);
+    }
+
     *gb              = nal->gb;
     s->nal_unit_type = nal->type;
     s->temporal_id   = nal->temporal_id;
@@ -3124,6 +3142,7 @@ static int decode_nal_unit(HEVCContext *s, const H2645NAL *nal)
             else
                 ctb_addr_ts = hls_slice_data(s);
             if (ctb_addr_ts >= (s->ps.sps->ctb_width * s->ps.sps->ctb_height)) {
+                ff_hevc_filter_thread_wait(s);
                 ret = hevc_frame_end(s);
                 if (ret < 0)
                     goto fail;
@@ -3240,6 +3259,7 @@ static int decode_nal_units(HEVCContext *s, const uint8_t *buf, int length)
     }
 
 fail:
+    ff_hevc_filter_thread_wait(s);
     if (s->ref && s->threads_type == FF_THREAD_FRAME)
         ff_thread_report_progress(&s->ref->tf, INT_MAX, 0);
 
@@ -3451,6 +3471,8 @@ static av_cold int hevc_decode_free(AVCodecContext *avctx)
     HEVCContext       *s = avctx->priv_data;
     int i;
 
+    ff_hevc_filter_thread_free(s);
+
     pic_arrays_free(s);
 
     ff_dovi_ctx_unref(&s->dovi_ctx);
@@ -3635,6 +3657,13 @@ static av_cold int hevc_decode_init(AVCodecContext *avctx)
         ret = ff_slice_thread_init_progress(avctx);
         if (ret < 0)
             return ret;
+    } else if ((avctx->active_thread_type & FF_THREAD_FRAME) && s->wpp_threads > 1) {
+        /* decode the WPP rows of each frame in parallel on top of
+         * frame threading */
+        ret = ff_slice_thread_init_nested(avctx, s->wpp_threads);
+        if (ret < 0)
+            return ret;
+        s->threads_number = ret;
     } else
         s->threads_number = 1;
 
@@ -3647,6 +3676,13 @@ static av_cold int hevc_decode_init(AVCodecContext *avctx)
     if (ret < 0)
         return ret;
 
+    /* WPP slice threads already filter each row right after decoding it */
+    if (s->filter_thread_opt && s->threads_number == 1) {
+        ret = ff_hevc_filter_thread_init(s);
+        if (ret < 0)
+            return ret;
+    }
+
     s->enable_parallel_tiles = 0;
     s->sei.picture_timing.picture_struct = 0;
     s->eos = 1;
@@ -3693,6 +3729,10 @@ static const AVOption options[] = {
         AV_OPT_TYPE_BOOL, {.i64 = 0}, 0, 1, PAR },
     { "strict-displaywin", "stricly apply default display window size", OFFSET(apply_defdispwin),
         AV_OPT_TYPE_BOOL, {.i64 = 0}, 0, 1, PAR },
+    { "wpp_threads", "Number of threads decoding WPP rows of each frame when frame threading is used",
+        OFFSET(wpp_threads), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 64, PAR },
+    { "filter_thread", "Run deblocking and SAO on a separate thread, overlapped with parsing",
+        OFFSET(filter_thread_opt), AV_OPT_TYPE_BOOL, {.i64 = 0}, 0, 1, PAR },
     { NULL },
 };
 
@@ -538,6 +538,9 @@ typedef struct HEVCContext {
     int is_nalff;           ///< this flag is != 0 if bitstream is encapsulated
                             ///< as a format defined in 14496-15
     int apply_defdispwin;
+    int wpp_threads;        ///< slice threads per frame thread for WPP rows
+    int filter_thread_opt;  ///< run deblocking and SAO on a helper thread
+    struct HEVCFilterThread *filter_thread;
 
     int nal_length_size;    ///< Number of bytes used for nal length (1, 2 or 4)
     int nuh_layer_id;
@@ -649,6 +652,18 @@ void ff_hevc_luma_mv_mvp_mode(HEVCLocalContext *lc, int x0, int y0,
                               MvField *mv, int mvp_lx_flag, int LX);
 void ff_hevc_hls_filter(HEVCLocalContext *lc, int x, int y, int ctb_size);
 void ff_hevc_hls_filters(HEVCLocalContext *lc, int x_ctb, int y_ctb, int ctb_size);
+
+/**
+ * Deferred in-loop filtering. When a filter thread is active, decoded CTBs
+ * are passed to ff_hevc_filter_thread_queue() in raster order instead of
+ * ff_hevc_hls_filters(), and deblocking/SAO runs on a helper thread.
+ * ff_hevc_filter_thread_wait() blocks until all queued CTBs are filtered.
+ */
+int  ff_hevc_filter_thread_init(HEVCContext *s);
+void ff_hevc_filter_thread_free(HEVCContext *s);
+int  ff_hevc_filter_thread_start_frame(HEVCContext *s);
+void ff_hevc_filter_thread_queue(HEVCContext *s, int ctb_addr_rs);
+void ff_hevc_filter_thread_wait(HEVCContext *s);
 void ff_hevc_set_qPy(HEVCLocalContext *lc, int xBase, int yBase,
                      int log2_cb_size);
 void ff_hevc_deblocking_boundary_strengths(HEVCLocalContext *lc, int x0, int y0,
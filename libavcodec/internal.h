@@ -63,6 +63,13 @@ typedef struct AVCodecInternal {
 
     void *thread_ctx;
 
+    /**
+     * Slice threading context owned by a frame threading worker context
+     * when frame and slice threading are combined, see
+     * ff_slice_thread_init_nested().
+     */
+    void *nested_thread_ctx;
+
     /**
      * This packet is used to hold the packet given to decoders
      * implementing the .decode API; it is unused by the generic
@@ -31,6 +31,7 @@
 #include "mathops.h"
 
 #include "libavutil/colorspace.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 
 #define RGBA(r,g,b,a) (((unsigned)(a) << 24) | ((r) << 16) | ((g) << 8) | (b))
@@ -73,6 +74,9 @@ typedef struct PGSSubObject {
     uint8_t      *rle;
     unsigned int rle_buffer_size, rle_data_len;
     unsigned int rle_remaining_len;
+    uint8_t      *bitmap;       ///< decoded rle, reused until new object data arrives
+    unsigned int bitmap_size;
+    int          bitmap_valid;
 } PGSSubObject;
 
 typedef struct PGSSubObjects {
@@ -107,6 +111,9 @@ static void flush_cache(AVCodecContext *avctx)
         av_freep(&ctx->objects.object[i].rle);
         ctx->objects.object[i].rle_buffer_size  = 0;
         ctx->objects.object[i].rle_remaining_len  = 0;
+        av_freep(&ctx->objects.object[i].bitmap);
+        ctx->objects.object[i].bitmap_size  = 0;
+        ctx->objects.object[i].bitmap_valid = 0;
     }
     ctx->objects.count = 0;
     ctx->palettes.count = 0;
@@ -151,30 +158,31 @@ static av_cold int close_decoder(AVCodecContext *avctx)
 /**
  * Decode the RLE data.
  *
- * The subtitle is stored as a Run Length Encoded image.
+ * The subtitle is stored as a Run Length Encoded image. The decoded
+ * bitmap is kept with the object, so that display sets which only
+ * change the palette or the position do not decode it again.
  *
  * @param avctx contains the current codec context
- * @param sub pointer to the processed subtitle data
- * @param buf pointer to the RLE data to process
- * @param buf_size size of the RLE data to process
+ * @param object the object whose RLE data to decode
  */
-static int decode_rle(AVCodecContext *avctx, AVSubtitleRect *rect,
-                      const uint8_t *buf, unsigned int buf_size)
+static int decode_rle(AVCodecContext *avctx, PGSSubObject *object)
 {
+    const uint8_t *buf = object->rle;
     const uint8_t *rle_bitmap_end;
+    const int w = object->w, h = object->h;
     int pixel_count, line_count;
 
-    rle_bitmap_end = buf + buf_size;
+    rle_bitmap_end = buf + object->rle_data_len;
 
-    rect->data[0] = av_malloc_array(rect->w, rect->h);
+    av_fast_malloc(&object->bitmap, &object->bitmap_size, w * h);
 
-    if (!rect->data[0])
+    if (!object->bitmap)
         return AVERROR(ENOMEM);
 
     pixel_count = 0;
     line_count  = 0;
 
-    while (buf < rle_bitmap_end && line_count < rect->h) {
+    while (buf < rle_bitmap_end && line_count < h) {
         uint8_t flags, color;
         int run;
 
@@ -189,17 +197,17 @@ static int decode_rle(AVCodecContext *avctx, AVSubtitleRect *rect,
             color = flags & 0x80 ? bytestream_get_byte(&buf) : 0;
         }
 
-        if (run > 0 && pixel_count + run <= rect->w * rect->h) {
-            memset(rect->data[0] + pixel_count, color, run);
+        if (run > 0 && pixel_count + run <= w * h) {
+            memset(object->bitmap + pixel_count, color, run);
             pixel_count += run;
         } else if (!run) {
             /*
              * New Line. Check if correct pixels decoded, if not display warning
              * and adjust bitmap pointer to correct new line position.
              */
-            if (pixel_count % rect->w > 0) {
+            if (pixel_count % w > 0) {
                 av_log(avctx, AV_LOG_ERROR, "Decoded %d pixels, when line should be %d pixels\n",
-                       pixel_count % rect->w, rect->w);
+                       pixel_count % w, w);
                 if (avctx->err_recognition & AV_EF_EXPLODE) {
                     return AVERROR_INVALIDDATA;
                 }
@@ -208,12 +216,14 @@ static int decode_rle(AVCodecContext *avctx, AVSubtitleRect *rect,
         }
     }
 
-    if (pixel_count < rect->w * rect->h) {
+    if (pixel_count < w * h) {
         av_log(avctx, AV_LOG_ERROR, "Insufficient RLE data for subtitle\n");
         return AVERROR_INVALIDDATA;
     }
 
-    ff_dlog(avctx, "Pixel Count = %d, Area = %d\n", pixel_count, rect->w * rect->h);
+    ff_dlog(avctx, "Pixel Count = %d, Area = %d\n", pixel_count, w * h);
+
+    object->bitmap_valid = 1;
 
     return 0;
 }
@@ -252,6 +262,7 @@ static int parse_object_segment(AVCodecContext *avctx,
         object = &ctx->objects.object[ctx->objects.count++];
         object->id = id;
     }
+    object->bitmap_valid = 0;
 
     /* skip object version number */
     buf += 1;
@@ -559,22 +570,27 @@ static int display_end_segment(AVCodecContext *avctx, AVSubtitle *sub,
 
             rect->linesize[0] = object->w;
 
-            if (object->rle_remaining_len) {
-                av_log(avctx, AV_LOG_ERROR, "RLE data length %u is %u bytes shorter than expected\n",
-                       object->rle_data_len, object->rle_remaining_len);
-                if (avctx->err_recognition & AV_EF_EXPLODE)
-                    return AVERROR_INVALIDDATA;
-            }
-            ret = decode_rle(avctx, rect, object->rle, object->rle_data_len);
-            if (ret < 0) {
-                if ((avctx->err_recognition & AV_EF_EXPLODE) ||
-                    ret == AVERROR(ENOMEM)) {
-                    return ret;
+            if (!object->bitmap_valid) {
+                if (object->rle_remaining_len) {
+                    av_log(avctx, AV_LOG_ERROR, "RLE data length %u is %u bytes shorter than expected\n",
+                           object->rle_data_len, object->rle_remaining_len);
+                    if (avctx->err_recognition & AV_EF_EXPLODE)
+                        return AVERROR_INVALIDDATA;
+                }
+                ret = decode_rle(avctx, object);
+                if (ret < 0) {
+                    if ((avctx->err_recognition & AV_EF_EXPLODE) ||
+                        ret == AVERROR(ENOMEM)) {
+                        return ret;
+                    }
+                    rect->w = 0;
+                    rect->h = 0;
+                    continue;
                 }
-                rect->w = 0;
-                rect->h = 0;
-                continue;
             }
+            rect->data[0] = av_memdup(object->bitmap, object->w * object->h);
+            if (!rect->data[0])
+                return AVERROR(ENOMEM);
         }
         /* Allocate memory for colors */
         rect->nb_colors = 256;
@@ -587,7 +587,10 @@ void ff_thread_report_progress(ThreadFrame *f, int n, int field)
 
     pthread_mutex_lock(&p->progress_mutex);
 
-    atomic_store_explicit(&progress[field], n, memory_order_release);
+    /* with slice threads nested in frame threads, progress may be
+     * reported concurrently; never let it go backwards */
+    if (atomic_load_explicit(&progress[field], memory_order_relaxed) < n)
+        atomic_store_explicit(&progress[field], n, memory_order_release);
 
     pthread_cond_broadcast(&p->progress_cond);
     pthread_mutex_unlock(&p->progress_mutex);
@@ -717,6 +720,8 @@ void ff_frame_thread_free(AVCodecContext *avctx, int thread_count)
             if (codec->close && p->thread_init != UNINITIALIZED)
                 codec->close(ctx);
 
+            ff_slice_thread_free_nested(ctx);
+
             /* When using a threadsafe hwaccel, this is where
              * each thread's context is uninit'd and freed. */
             ff_hwaccel_uninit(ctx);
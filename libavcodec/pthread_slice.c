@@ -61,16 +61,24 @@ typedef struct SliceThreadContext {
     Progress *progress;
 } SliceThreadContext;
 
+static SliceThreadContext *slice_thread_ctx(const AVCodecContext *avctx)
+{
+    const AVCodecInternal *avci = avctx->internal;
+
+    /* a frame threading worker may own a nested slice threading context */
+    return avci->nested_thread_ctx ? avci->nested_thread_ctx : avci->thread_ctx;
+}
+
 static void main_function(void *priv) {
     AVCodecContext *avctx = priv;
-    SliceThreadContext *c = avctx->internal->thread_ctx;
+    SliceThreadContext *c = slice_thread_ctx(avctx);
     c->mainfunc(avctx);
 }
 
 static void worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
 {
     AVCodecContext *avctx = priv;
-    SliceThreadContext *c = avctx->internal->thread_ctx;
+    SliceThreadContext *c = slice_thread_ctx(avctx);
     int ret;
 
     ret = c->func ? c->func(avctx, (char *)c->args + c->job_size * jobnr)
@@ -79,9 +87,9 @@ static void worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb
         c->rets[jobnr] = ret;
 }
 
-void ff_slice_thread_free(AVCodecContext *avctx)
+static void slice_thread_free(void **ctx)
 {
-    SliceThreadContext *c = avctx->internal->thread_ctx;
+    SliceThreadContext *c = *ctx;
     int i;
 
     avpriv_slicethread_free(&c->thread);
@@ -94,14 +102,26 @@ void ff_slice_thread_free(AVCodecContext *avctx)
 
     av_freep(&c->entries);
     av_freep(&c->progress);
-    av_freep(&avctx->internal->thread_ctx);
+    av_freep(ctx);
+}
+
+void ff_slice_thread_free(AVCodecContext *avctx)
+{
+    slice_thread_free(&avctx->internal->thread_ctx);
+}
+
+void ff_slice_thread_free_nested(AVCodecContext *avctx)
+{
+    if (avctx->internal->nested_thread_ctx)
+        slice_thread_free(&avctx->internal->nested_thread_ctx);
 }
 
 static int thread_execute(AVCodecContext *avctx, action_func* func, void *arg, int *ret, int job_count, int job_size)
 {
-    SliceThreadContext *c = avctx->internal->thread_ctx;
+    SliceThreadContext *c = slice_thread_ctx(avctx);
 
-    if (!(avctx->active_thread_type&FF_THREAD_SLICE) || avctx->thread_count <= 1)
+    if (!avctx->internal->nested_thread_ctx &&
+        (!(avctx->active_thread_type&FF_THREAD_SLICE) || avctx->thread_count <= 1))
         return avcodec_default_execute(avctx, func, arg, ret, job_count, job_size);
 
     if (job_count <= 0)
@@ -118,14 +138,14 @@ static int thread_execute(AVCodecContext *avctx, action_func* func, void *arg, i
 
 static int thread_execute2(AVCodecContext *avctx, action_func2* func2, void *arg, int *ret, int job_count)
 {
-    SliceThreadContext *c = avctx->internal->thread_ctx;
+    SliceThreadContext *c = slice_thread_ctx(avctx);
     c->func2 = func2;
     return thread_execute(avctx, NULL, arg, ret, job_count, 0);
 }
 
 int ff_slice_thread_execute_with_mainfunc(AVCodecContext *avctx, action_func2* func2, main_func *mainfunc, void *arg, int *ret, int job_count)
 {
-    SliceThreadContext *c = avctx->internal->thread_ctx;
+    SliceThreadContext *c = slice_thread_ctx(avctx);
     c->func2 = func2;
     c->mainfunc = mainfunc;
     return thread_execute(avctx, NULL, arg, ret, job_count, 0);
@@ -176,10 +196,9 @@ int ff_slice_thread_init(AVCodecContext *avctx)
     return 0;
 }
 
-int av_cold ff_slice_thread_init_progress(AVCodecContext *avctx)
+static av_cold int init_progress(SliceThreadContext *p, int thread_count)
 {
-    SliceThreadContext *const p = avctx->internal->thread_ctx;
-    int err, i = 0, thread_count = avctx->thread_count;
+    int err, i = 0;
 
     p->progress = av_calloc(thread_count, sizeof(*p->progress));
     if (!p->progress) {
@@ -207,9 +226,47 @@ fail:
     return err;
 }
 
+int av_cold ff_slice_thread_init_progress(AVCodecContext *avctx)
+{
+    return init_progress(avctx->internal->thread_ctx, avctx->thread_count);
+}
+
+int av_cold ff_slice_thread_init_nested(AVCodecContext *avctx, int thread_count)
+{
+    AVCodecInternal *avci = avctx->internal;
+    SliceThreadContext *c;
+    int err;
+
+    av_assert0(!avci->nested_thread_ctx);
+
+    if (thread_count <= 1)
+        return 1;
+
+    avci->nested_thread_ctx = c = av_mallocz(sizeof(*c));
+    if (!c)
+        return AVERROR(ENOMEM);
+
+    thread_count = avpriv_slicethread_create(&c->thread, avctx, worker_func,
+                                             NULL, thread_count);
+    if (thread_count <= 1) {
+        ff_slice_thread_free_nested(avctx);
+        return thread_count < 0 ? thread_count : 1;
+    }
+
+    err = init_progress(c, thread_count);
+    if (err < 0) {
+        ff_slice_thread_free_nested(avctx);
+        return err;
+    }
+
+    avctx->execute  = thread_execute;
+    avctx->execute2 = thread_execute2;
+    return thread_count;
+}
+
 void ff_thread_report_progress2(AVCodecContext *avctx, int field, int thread, int n)
 {
-    SliceThreadContext *p = avctx->internal->thread_ctx;
+    SliceThreadContext *p = slice_thread_ctx(avctx);
     Progress *const progress = &p->progress[thread];
     int *entries = p->entries;
 
@@ -221,7 +278,7 @@ void ff_thread_report_progress2(AVCodecContext *avctx, int field, int thread, in
 
 void ff_thread_await_progress2(AVCodecContext *avctx, int field, int thread, int shift)
 {
-    SliceThreadContext *p  = avctx->internal->thread_ctx;
+    SliceThreadContext *p  = slice_thread_ctx(avctx);
     Progress *progress;
     int *entries      = p->entries;
 
@@ -239,8 +296,9 @@ void ff_thread_await_progress2(AVCodecContext *avctx, int field, int thread, int
 
 int ff_slice_thread_allocz_entries(AVCodecContext *avctx, int count)
 {
-    if (avctx->active_thread_type & FF_THREAD_SLICE)  {
-        SliceThreadContext *p = avctx->internal->thread_ctx;
+    if ((avctx->active_thread_type & FF_THREAD_SLICE) ||
+        avctx->internal->nested_thread_ctx) {
+        SliceThreadContext *p = slice_thread_ctx(avctx);
 
         if (p->entries_count == count) {
             memset(p->entries, 0, p->entries_count * sizeof(*p->entries));
@@ -81,6 +81,19 @@ int ff_slice_thread_execute_with_mainfunc(AVCodecContext *avctx,
 void ff_thread_free(AVCodecContext *s);
 int ff_slice_thread_allocz_entries(AVCodecContext *avctx, int count);
 int ff_slice_thread_init_progress(AVCodecContext *avctx);
+
+/**
+ * Create a slice thread pool for a frame threading worker context, so that
+ * execute()/execute2() and the progress2 functions can be used on it while
+ * several frames are decoded in parallel. The progress entries are
+ * initialized for the returned number of threads.
+ *
+ * @param avctx        frame threading worker context
+ * @param thread_count number of slice threads to use per frame thread
+ * @return the number of slice threads (1 if none were created) or
+ *         a negative error code
+ */
+int ff_slice_thread_init_nested(AVCodecContext *avctx, int thread_count);
 void ff_thread_report_progress2(AVCodecContext *avctx, int field, int thread, int n);
 void ff_thread_await_progress2(AVCodecContext *avctx,  int field, int thread, int shift);
 
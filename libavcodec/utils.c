@@ -927,6 +927,11 @@ int ff_slice_thread_init_progress(AVCodecContext *avctx)
     return 0;
 }
 
+int ff_slice_thread_init_nested(AVCodecContext *avctx, int thread_count)
+{
+    return 1;
+}
+
 int ff_slice_thread_allocz_entries(AVCodecContext *avctx, int count)
 {
     return 0;
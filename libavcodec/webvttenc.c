@@ -20,137 +20,21 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
-#include <stdarg.h>
 #include "avcodec.h"
 #include "libavutil/bprint.h"
 #include "ass_split.h"
-#include "ass.h"
+#include "ass2webvtt.h"
 #include "codec_internal.h"
 
-#define WEBVTT_STACK_SIZE 64
 typedef struct {
     AVCodecContext *avctx;
     ASSSplitContext *ass_ctx;
     AVBPrint buffer;
     unsigned timestamp_end;
     int count;
-    char stack[WEBVTT_STACK_SIZE];
-    int stack_ptr;
+    FFASS2WebVTTContext conv;
 } WebVTTContext;
 
-static av_printf_format(2, 3) void webvtt_print(WebVTTContext *s, const char *str, ...)
-{
-    va_list vargs;
-    va_start(vargs, str);
-    av_vbprintf(&s->buffer, str, vargs);
-    va_end(vargs);
-}
-
-static int webvtt_stack_push(WebVTTContext *s, const char c)
-{
-    if (s->stack_ptr >= WEBVTT_STACK_SIZE)
-        return -1;
-    s->stack[s->stack_ptr++] = c;
-    return 0;
-}
-
-static char webvtt_stack_pop(WebVTTContext *s)
-{
-    if (s->stack_ptr <= 0)
-        return 0;
-    return s->stack[--s->stack_ptr];
-}
-
-static int webvtt_stack_find(WebVTTContext *s, const char c)
-{
-    int i;
-    for (i = s->stack_ptr-1; i >= 0; i--)
-        if (s->stack[i] == c)
-            break;
-    return i;
-}
-
-static void webvtt_close_tag(WebVTTContext *s, char tag)
-{
-    webvtt_print(s, "</%c>", tag);
-}
-
-static void webvtt_stack_push_pop(WebVTTContext *s, const char c, int close)
-{
-    if (close) {
-        int i = c ? webvtt_stack_find(s, c) : 0;
-        if (i < 0)
-            return;
-        while (s->stack_ptr != i)
-            webvtt_close_tag(s, webvtt_stack_pop(s));
-    } else if (webvtt_stack_push(s, c) < 0)
-        av_log(s->avctx, AV_LOG_ERROR, "tag stack overflow\n");
-}
-
-static void webvtt_style_apply(WebVTTContext *s, const char *style)
-{
-    ASSStyle *st = ff_ass_style_get(s->ass_ctx, style);
-    if (st) {
-        if (st->bold != ASS_DEFAULT_BOLD) {
-            webvtt_print(s, "<b>");
-            webvtt_stack_push(s, 'b');
-        }
-        if (st->italic != ASS_DEFAULT_ITALIC) {
-            webvtt_print(s, "<i>");
-            webvtt_stack_push(s, 'i');
-        }
-        if (st->underline != ASS_DEFAULT_UNDERLINE) {
-            webvtt_print(s, "<u>");
-            webvtt_stack_push(s, 'u');
-        }
-    }
-}
-
-static void webvtt_text_cb(void *priv, const char *text, int len)
-{
-    WebVTTContext *s = priv;
-    av_bprint_append_data(&s->buffer, text, len);
-}
-
-static void webvtt_new_line_cb(void *priv, int forced)
-{
-    webvtt_print(priv, "\n");
-}
-
-static void webvtt_style_cb(void *priv, char style, int close)
-{
-    if (style == 's') // strikethrough unsupported
-        return;
-
-    webvtt_stack_push_pop(priv, style, close);
-    if (!close)
-        webvtt_print(priv, "<%c>", style);
-}
-
-static void webvtt_cancel_overrides_cb(void *priv, const char *style)
-{
-    webvtt_stack_push_pop(priv, 0, 1);
-    webvtt_style_apply(priv, style);
-}
-
-static void webvtt_end_cb(void *priv)
-{
-    webvtt_stack_push_pop(priv, 0, 1);
-}
-
-static const ASSCodesCallbacks webvtt_callbacks = {
-    .text             = webvtt_text_cb,
-    .new_line         = webvtt_new_line_cb,
-    .style            = webvtt_style_cb,
-    .color            = NULL,
-    .font_name        = NULL,
-    .font_size        = NULL,
-    .alignment        = NULL,
-    .cancel_overrides = webvtt_cancel_overrides_cb,
-    .move             = NULL,
-    .end              = webvtt_end_cb,
-};
-
 static int webvtt_encode_frame(AVCodecContext *avctx,
                                unsigned char *buf, int bufsize, const AVSubtitle *sub)
 {
@@ -171,8 +55,7 @@ static int webvtt_encode_frame(AVCodecContext *avctx,
         dialog = ff_ass_split_dialog(s->ass_ctx, ass);
         if (!dialog)
             return AVERROR(ENOMEM);
-        webvtt_style_apply(s, dialog->style);
-        ff_ass_split_override_codes(&webvtt_callbacks, s, dialog->text);
+        ff_ass2webvtt_event(&s->conv, dialog->style, dialog->text);
         ff_ass_free_dialog(&dialog);
     }
 
@@ -199,6 +82,9 @@ static av_cold int webvtt_encode_init(AVCodecContext *avctx)
     WebVTTContext *s = avctx->priv_data;
     s->avctx = avctx;
     s->ass_ctx = ff_ass_split(avctx->subtitle_header);
+    s->conv.log_ctx = avctx;
+    s->conv.ass_ctx = s->ass_ctx;
+    s->conv.buffer  = &s->buffer;
     return s->ass_ctx ? 0 : AVERROR_INVALIDDATA;
 }
 
@@ -22,9 +22,9 @@
 
 %include "libavutil/x86/x86util.asm"
 
-SECTION_RODATA
+SECTION_RODATA 32
 
-float_abs_mask: times 4 dd 0x7fffffff
+float_abs_mask: times 8 dd 0x7fffffff
 
 SECTION .text
 
@@ -48,6 +48,37 @@ cglobal abs_pow34, 3, 3, 3, out, in, size
     jl    .loop
     RET
 
+; Bands are only guaranteed to be a multiple of 4 coefficients long, so the
+; ymm versions finish with one xmm iteration when needed.
+INIT_YMM avx
+cglobal abs_pow34, 3, 3, 3, out, in, size
+    mova   m2, [float_abs_mask]
+    shl    sized, 2
+    add    inq, sizeq
+    add    outq, sizeq
+    neg    sizeq
+    cmp    sizeq, -mmsize
+    jg    .tail
+.loop:
+    andps  m0, m2, [inq+sizeq]
+    sqrtps m1, m0
+    mulps  m0, m1
+    sqrtps m0, m0
+    movu   [outq+sizeq], m0
+    add    sizeq, mmsize
+    cmp    sizeq, -mmsize
+    jle   .loop
+.tail:
+    test   sizeq, sizeq
+    jz    .end
+    andps  xm0, xm2, [inq+sizeq]
+    sqrtps xm1, xm0
+    mulps  xm0, xm1
+    sqrtps xm0, xm0
+    movu   [outq+sizeq], xm0
+.end:
+    RET
+
 ;*******************************************************************
 ;void ff_aac_quantize_bands(int *out, const float *in, const float *scaled,
 ;                           int size, int is_signed, int maxval, const float Q34,
@@ -84,3 +115,115 @@ cglobal aac_quantize_bands, 5, 5, 6, out, in, scaled, size, is_signed, maxval, Q
     add       sizeq, mmsize
     jl       .loop
     RET
+
+INIT_YMM avx
+cglobal aac_quantize_bands, 5, 5, 6, out, in, scaled, size, is_signed, maxval, Q34, rounding
+%if UNIX64 == 0
+    movss     xm0, Q34m
+    movss     xm1, roundingm
+    cvtsi2ss  xm3, dword maxvalm
+%else
+    cvtsi2ss  xm3, maxvald
+%endif
+    shufps    xm0, xm0, 0
+    shufps    xm1, xm1, 0
+    shufps    xm3, xm3, 0
+    shl       is_signedd, 31
+    movd      xm4, is_signedd
+    shufps    xm4, xm4, 0
+    vinsertf128 m0, m0, xm0, 1
+    vinsertf128 m1, m1, xm1, 1
+    vinsertf128 m3, m3, xm3, 1
+    vinsertf128 m4, m4, xm4, 1
+    shl       sized,   2
+    add       inq, sizeq
+    add       outq, sizeq
+    add       scaledq, sizeq
+    neg       sizeq
+    cmp       sizeq, -mmsize
+    jg       .tail
+.loop:
+    mulps     m2, m0, [scaledq+sizeq]
+    addps     m2, m1
+    minps     m2, m3
+    andps     m5, m4, [inq+sizeq]
+    orps      m2, m5
+    cvttps2dq m2, m2
+    movu      [outq+sizeq], m2
+    add       sizeq, mmsize
+    cmp       sizeq, -mmsize
+    jle      .loop
+.tail:
+    test      sizeq, sizeq
+    jz       .end
+    mulps     xm2, xm0, [scaledq+sizeq]
+    addps     xm2, xm1
+    minps     xm2, xm3
+    andps     xm5, xm4, [inq+sizeq]
+    orps      xm2, xm5
+    cvttps2dq xm2, xm2
+    movu      [outq+sizeq], xm2
+.end:
+    RET
+
+;*******************************************************************
+;void ff_aac_band_energy(float *energy, float *form_factor,
+;                        const float *coefs, int size)
+;*******************************************************************
+%macro BAND_ENERGY 0
+cglobal aac_band_energy, 4, 4, 5, energy, form_factor, coefs, size
+    mova      m4, [float_abs_mask]
+    xorps     m0, m0
+    xorps     m1, m1
+    shl       sized, 2
+    add       coefsq, sizeq
+    neg       sizeq
+%if mmsize == 32
+    cmp       sizeq, -mmsize
+    jg       .tail
+%endif
+.loop:
+    movu      m2, [coefsq+sizeq]
+    andps     m3, m4, m2
+    mulps     m2, m2
+    sqrtps    m3, m3
+    addps     m0, m2
+    addps     m1, m3
+    add       sizeq, mmsize
+%if mmsize == 32
+    cmp       sizeq, -mmsize
+    jle      .loop
+.tail:
+    test      sizeq, sizeq
+    jz       .end
+    movu      xm2, [coefsq+sizeq]
+    andps     xm3, xm4, xm2
+    mulps     xm2, xm2
+    sqrtps    xm3, xm3
+    addps     m0, m2
+    addps     m1, m3
+.end:
+    vextractf128 xm2, m0, 1
+    vextractf128 xm3, m1, 1
+    addps     xm0, xm2
+    addps     xm1, xm3
+%else
+    jl       .loop
+%endif
+    movhlps   xm2, xm0
+    movhlps   xm3, xm1
+    addps     xm0, xm2
+    addps     xm1, xm3
+    shufps    xm2, xm0, xm0, q0001
+    shufps    xm3, xm1, xm1, q0001
+    addss     xm0, xm2
+    addss     xm1, xm3
+    movss     [energyq], xm0
+    movss     [form_factorq], xm1
+    RET
+%endmacro
+
+INIT_XMM sse
+BAND_ENERGY
+INIT_YMM avx
+BAND_ENERGY
@@ -26,18 +26,35 @@
 #include "libavcodec/aacencdsp.h"
 
 void ff_abs_pow34_sse(float *out, const float *in, const int size);
+void ff_abs_pow34_avx(float *out, const float *in, const int size);
 
 void ff_aac_quantize_bands_sse2(int *out, const float *in, const float *scaled,
                                 int size, int is_signed, int maxval, const float Q34,
                                 const float rounding);
+void ff_aac_quantize_bands_avx(int *out, const float *in, const float *scaled,
+                               int size, int is_signed, int maxval, const float Q34,
+                               const float rounding);
+
+void ff_aac_band_energy_sse(float *energy, float *form_factor,
+                            const float *coefs, int size);
+void ff_aac_band_energy_avx(float *energy, float *form_factor,
+                            const float *coefs, int size);
 
 av_cold void ff_aacenc_dsp_init_x86(AACEncDSPContext *s)
 {
     int cpu_flags = av_get_cpu_flags();
 
-    if (EXTERNAL_SSE(cpu_flags))
+    if (EXTERNAL_SSE(cpu_flags)) {
         s->abs_pow34   = ff_abs_pow34_sse;
+        s->band_energy = ff_aac_band_energy_sse;
+    }
 
     if (EXTERNAL_SSE2(cpu_flags))
         s->quant_bands = ff_aac_quantize_bands_sse2;
+
+    if (EXTERNAL_AVX_FAST(cpu_flags)) {
+        s->abs_pow34   = ff_abs_pow34_avx;
+        s->quant_bands = ff_aac_quantize_bands_avx;
+        s->band_energy = ff_aac_band_energy_avx;
+    }
 }
@@ -127,6 +127,24 @@ pb_qpel_shuffle_index: db  0,  1,  2,  3
                        db 18, 19, 20, 21
                        db 19, 20, 21, 22
 
+; word pairs (x + 2*k, x + 2*k + 1) for dword lane x, one 64-byte row per k
+pw_pel10_shuffle_index: dw  0,  1,  1,  2,  2,  3,  3,  4
+                        dw  4,  5,  5,  6,  6,  7,  7,  8
+                        dw  8,  9,  9, 10, 10, 11, 11, 12
+                        dw 12, 13, 13, 14, 14, 15, 15, 16
+                        dw  2,  3,  3,  4,  4,  5,  5,  6
+                        dw  6,  7,  7,  8,  8,  9,  9, 10
+                        dw 10, 11, 11, 12, 12, 13, 13, 14
+                        dw 14, 15, 15, 16, 16, 17, 17, 18
+                        dw  4,  5,  5,  6,  6,  7,  7,  8
+                        dw  8,  9,  9, 10, 10, 11, 11, 12
+                        dw 12, 13, 13, 14, 14, 15, 15, 16
+                        dw 16, 17, 17, 18, 18, 19, 19, 20
+                        dw  6,  7,  7,  8,  8,  9,  9, 10
+                        dw 10, 11, 11, 12, 12, 13, 13, 14
+                        dw 14, 15, 15, 16, 16, 17, 17, 18
+                        dw 18, 19, 19, 20, 20, 21, 21, 22
+
 SECTION .text
 
 %define MAX_PB_SIZE  64
@@ -1414,6 +1432,66 @@ cglobal hevc_put_hevc_qpel_hv%1_%2, 6, 7, 27, dst, src, srcstride, height, mx, m
     RET
 %endmacro
 
+; high bit depth horizontal filters: the samples of each tap pair are
+; gathered with vpermw and multiplied with vpdpwssd
+; %1: number of taps, %2: name for mx, %3: name for tmp
+%macro PEL_FILTER_H10 3
+%if %1 == 8
+%define %%table hevc_qpel_filters_sse4_10
+%assign %%log2_size 6
+%else
+%define %%table hevc_epel_filters_sse4_10
+%assign %%log2_size 5
+%endif
+    dec             %2q
+    shl             %2q, %%log2_size
+%if PIC
+    lea             %3q, [%%table]
+    %define FILTER %3q
+%else
+    %define FILTER %%table
+%endif
+%assign %%i 0
+%rep %1 / 2
+%assign %%j %%i + 4
+    vpbroadcastd  m %+ %%i, [FILTER + %2q + 16*%%i]
+    movu          m %+ %%j, [pw_pel10_shuffle_index + 64*%%i]
+%assign %%i %%i+1
+%endrep
+    ; only load the samples that are actually used
+    mov            %3d, (1 << (mmsize / 4 + %1 - 1)) - 1
+    kmovd           k1, %3d
+%endmacro
+
+; %1: number of taps, %2: dst register index, %3: name for src, %4: offset
+%macro PEL_H10_LOAD_COMPUTE 4
+    pxor                   m%2, m%2
+    vmovdqu16          m8{k1}{z}, [%3q + 2*(%4 - %1/2 + 1)]
+%assign %%i 0
+%rep %1 / 2
+%assign %%j %%i + 4
+    vpermw                  m9, m %+ %%j, m8
+    vpdpwssd               m%2, m9, m %+ %%i
+%assign %%i %%i+1
+%endrep
+    vpsrad                 m%2, 2
+%endmacro
+
+; %1: qpel/epel, %2: number of taps, %3: width
+%macro HEVC_PUT_HEVC_PEL_H10_AVX512ICL 3
+cglobal hevc_put_hevc_%1_h%3_10, 5, 6, 12, dst, src, srcstride, height, mx, tmp
+    PEL_FILTER_H10         %2, mx, tmp
+.loop:
+%assign %%x 0
+%rep %3 / (mmsize / 4)
+    PEL_H10_LOAD_COMPUTE   %2, 10, src, %%x
+    vpmovdw   [dstq + 2*%%x], m10
+%assign %%x %%x + mmsize / 4
+%endrep
+    LOOP_END               dst, src, srcstride
+    RET
+%endmacro
+
 %if ARCH_X86_64
 %if HAVE_AVX512ICL_EXTERNAL
 
@@ -1423,11 +1501,19 @@ HEVC_PUT_HEVC_QPEL_AVX512ICL 4, 8
 INIT_YMM avx512icl
 HEVC_PUT_HEVC_QPEL_AVX512ICL 8, 8
 HEVC_PUT_HEVC_QPEL_HV_AVX512ICL 8, 8
+HEVC_PUT_HEVC_PEL_H10_AVX512ICL qpel, 8, 8
+HEVC_PUT_HEVC_PEL_H10_AVX512ICL epel, 4, 8
 
 INIT_ZMM avx512icl
 HEVC_PUT_HEVC_QPEL_AVX512ICL 16, 8
 HEVC_PUT_HEVC_QPEL_AVX512ICL 32, 8
 HEVC_PUT_HEVC_QPEL_AVX512ICL 64, 8
+HEVC_PUT_HEVC_PEL_H10_AVX512ICL qpel, 8, 16
+HEVC_PUT_HEVC_PEL_H10_AVX512ICL qpel, 8, 32
+HEVC_PUT_HEVC_PEL_H10_AVX512ICL qpel, 8, 64
+HEVC_PUT_HEVC_PEL_H10_AVX512ICL epel, 4, 16
+HEVC_PUT_HEVC_PEL_H10_AVX512ICL epel, 4, 32
+HEVC_PUT_HEVC_PEL_H10_AVX512ICL epel, 4, 64
 
 %endif
 %endif
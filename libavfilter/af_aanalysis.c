@@ -0,0 +1,307 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Audio analysis: per-window RMS level, silence detection and a spectral
+ * sub-fingerprint in the style of Haitsma and Kalker.
+ */
+
+#include <math.h>
+
+#include "libavutil/ffmath.h"
+#include "libavutil/float_dsp.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/timestamp.h"
+#include "libavutil/tx.h"
+#include "audio.h"
+#include "avfilter.h"
+#include "filters.h"
+#include "internal.h"
+
+/* number of fingerprint bits, one per pair of adjacent bands */
+#define NB_BITS      32
+#define MIN_FREQ    300.0
+#define MAX_FREQ   2000.0
+
+typedef struct AudioAnalysisContext {
+    const AVClass *class;
+    int64_t window;             ///< analysis window duration
+    double noise;               ///< silence threshold in dB
+    int64_t duration;           ///< minimum silence duration
+
+    int window_samples;
+    int fft_size;
+    float noise_power;          ///< silence threshold as mean square
+    int band_start[NB_BITS + 2];
+    float band_diff[NB_BITS];   ///< energy differences of the previous window
+
+    int64_t silence_start;      ///< pts of the first silent window or AV_NOPTS_VALUE
+    int64_t silence_end;        ///< end pts of the last silent window
+    int silence_reported;
+
+    float *mono;
+    float *tmp;
+    float *win;
+    float *windowed;
+    AVComplexFloat *spectrum;
+    AVTXContext *tx;
+    av_tx_fn tx_fn;
+    AVFloatDSPContext *fdsp;
+} AudioAnalysisContext;
+
+#define MAX_DURATION (24*3600*1000000LL)
+#define OFFSET(x) offsetof(AudioAnalysisContext, x)
+#define FLAGS AV_OPT_FLAG_FILTERING_PARAM|AV_OPT_FLAG_AUDIO_PARAM
+static const AVOption aanalysis_options[] = {
+    { "window",   "set analysis window duration",     OFFSET(window),   AV_OPT_TYPE_DURATION, {.i64=100000},  10000, 10000000,     FLAGS },
+    { "w",        "set analysis window duration",     OFFSET(window),   AV_OPT_TYPE_DURATION, {.i64=100000},  10000, 10000000,     FLAGS },
+    { "noise",    "set silence threshold in dB",      OFFSET(noise),    AV_OPT_TYPE_DOUBLE,   {.dbl=-60},     -200,  0,            FLAGS },
+    { "n",        "set silence threshold in dB",      OFFSET(noise),    AV_OPT_TYPE_DOUBLE,   {.dbl=-60},     -200,  0,            FLAGS },
+    { "duration", "set minimum silence duration",     OFFSET(duration), AV_OPT_TYPE_DURATION, {.i64=2000000}, 0,     MAX_DURATION, FLAGS },
+    { "d",        "set minimum silence duration",     OFFSET(duration), AV_OPT_TYPE_DURATION, {.i64=2000000}, 0,     MAX_DURATION, FLAGS },
+    { NULL }
+};
+
+AVFILTER_DEFINE_CLASS(aanalysis);
+
+static int config_input(AVFilterLink *inlink)
+{
+    AVFilterContext *ctx = inlink->dst;
+    AudioAnalysisContext *s = ctx->priv;
+    const float scale = 1.f;
+    double bin_hz, max_freq;
+    int ret;
+
+    s->window_samples = FFMAX(av_rescale(s->window, inlink->sample_rate, AV_TIME_BASE), 16);
+    s->fft_size       = 1 << av_ceil_log2(FFMAX(s->window_samples, 64));
+    s->noise_power    = ff_exp10(s->noise / 10.);
+    s->silence_start  = AV_NOPTS_VALUE;
+
+    s->mono     = av_calloc(s->fft_size, sizeof(*s->mono));
+    s->tmp      = av_calloc(s->fft_size, sizeof(*s->tmp));
+    s->win      = av_calloc(s->fft_size, sizeof(*s->win));
+    s->windowed = av_calloc(s->fft_size, sizeof(*s->windowed));
+    s->spectrum = av_calloc(s->fft_size / 2 + 1, sizeof(*s->spectrum));
+    if (!s->mono || !s->tmp || !s->win || !s->windowed || !s->spectrum)
+        return AVERROR(ENOMEM);
+
+    for (int i = 0; i < s->window_samples; i++)
+        s->win[i] = 0.5f - 0.5f * cosf(2.f * M_PI * i / (s->window_samples - 1));
+
+    ret = av_tx_init(&s->tx, &s->tx_fn, AV_TX_FLOAT_RDFT, 0, s->fft_size, &scale, 0);
+    if (ret < 0)
+        return ret;
+
+    /* logarithmically spaced bands between MIN_FREQ and MAX_FREQ, each at
+     * least one bin wide */
+    bin_hz   = inlink->sample_rate / (double)s->fft_size;
+    max_freq = FFMIN(MAX_FREQ, inlink->sample_rate * 0.5);
+    for (int b = 0; b <= NB_BITS + 1; b++) {
+        const double f = MIN_FREQ * pow(max_freq / MIN_FREQ, b / (double)(NB_BITS + 1));
+        int bin = lrint(f / bin_hz);
+
+        if (b)
+            bin = FFMAX(bin, s->band_start[b - 1] + 1);
+        s->band_start[b] = FFMIN(bin, s->fft_size / 2 + 1);
+    }
+
+    return 0;
+}
+
+static void set_meta(AVFrame *frame, const char *key, const char *value)
+{
+    char key2[128];
+
+    snprintf(key2, sizeof(key2), "lavfi.aanalysis.%s", key);
+    av_dict_set(&frame->metadata, key2, value, 0);
+}
+
+static void report_silence_end(AVFilterContext *ctx, AVFrame *frame)
+{
+    AudioAnalysisContext *s = ctx->priv;
+    const AVRational tb = ctx->inputs[0]->time_base;
+    const int64_t duration = s->silence_end - s->silence_start;
+
+    if (frame) {
+        set_meta(frame, "silence_end", av_ts2timestr(s->silence_end, &tb));
+        set_meta(frame, "silence_duration", av_ts2timestr(duration, &tb));
+    }
+    av_log(ctx, AV_LOG_INFO, "silence_end: %s | silence_duration: %s\n",
+           av_ts2timestr(s->silence_end, &tb), av_ts2timestr(duration, &tb));
+}
+
+static void update_silence(AVFilterContext *ctx, AVFrame *frame, int silent)
+{
+    AudioAnalysisContext *s = ctx->priv;
+    AVFilterLink *inlink = ctx->inputs[0];
+
+    if (!silent) {
+        if (s->silence_reported)
+            report_silence_end(ctx, frame);
+        s->silence_start    = AV_NOPTS_VALUE;
+        s->silence_reported = 0;
+        return;
+    }
+
+    if (s->silence_start == AV_NOPTS_VALUE)
+        s->silence_start = frame->pts;
+    s->silence_end = frame->pts + av_rescale_q(frame->nb_samples,
+                                               (AVRational){ 1, inlink->sample_rate },
+                                               inlink->time_base);
+
+    if (!s->silence_reported &&
+        av_rescale_q(s->silence_end - s->silence_start, inlink->time_base,
+                     AV_TIME_BASE_Q) >= s->duration) {
+        const char *start = av_ts2timestr(s->silence_start, &inlink->time_base);
+
+        s->silence_reported = 1;
+        set_meta(frame, "silence_start", start);
+        av_log(ctx, AV_LOG_INFO, "silence_start: %s\n", start);
+    }
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *in)
+{
+    AVFilterContext *ctx = inlink->dst;
+    AudioAnalysisContext *s = ctx->priv;
+    const int nb_samples  = in->nb_samples;
+    const int nb_channels = in->ch_layout.nb_channels;
+    const int len = FFALIGN(nb_samples, 16);
+    float energy[NB_BITS + 1];
+    uint32_t fingerprint = 0;
+    char value[128];
+    float power;
+
+    /* mix down to mono; all processing lengths are padded to a multiple of
+     * 16 as required by the float DSP functions */
+    memset(s->mono, 0, s->fft_size * sizeof(*s->mono));
+    memset(s->tmp + nb_samples, 0, (len - nb_samples) * sizeof(*s->tmp));
+    for (int ch = 0; ch < nb_channels; ch++) {
+        memcpy(s->tmp, in->extended_data[ch], nb_samples * sizeof(*s->tmp));
+        s->fdsp->vector_fmac_scalar(s->mono, s->tmp, 1.f / nb_channels, len);
+    }
+
+    power = s->fdsp->scalarproduct_float(s->mono, s->mono, len) / nb_samples;
+    snprintf(value, sizeof(value), "%f", 10.f * log10f(power));
+    set_meta(in, "rms_level", value);
+
+    s->fdsp->vector_fmul(s->windowed, s->mono, s->win, s->fft_size);
+    s->tx_fn(s->tx, s->spectrum, s->windowed, sizeof(float));
+
+    for (int b = 0; b <= NB_BITS; b++) {
+        float sum = 0.f;
+
+        for (int i = s->band_start[b]; i < s->band_start[b + 1]; i++)
+            sum += s->spectrum[i].re * s->spectrum[i].re +
+                   s->spectrum[i].im * s->spectrum[i].im;
+        energy[b] = sum;
+    }
+
+    for (int b = 0; b < NB_BITS; b++) {
+        const float diff = energy[b] - energy[b + 1];
+
+        fingerprint |= (uint32_t)(diff - s->band_diff[b] > 0.f) << (NB_BITS - 1 - b);
+        s->band_diff[b] = diff;
+    }
+    snprintf(value, sizeof(value), "%08"PRIX32, fingerprint);
+    set_meta(in, "fingerprint", value);
+
+    update_silence(ctx, in, power <= s->noise_power);
+
+    return ff_filter_frame(ctx->outputs[0], in);
+}
+
+static int activate(AVFilterContext *ctx)
+{
+    AVFilterLink *inlink = ctx->inputs[0];
+    AVFilterLink *outlink = ctx->outputs[0];
+    AudioAnalysisContext *s = ctx->priv;
+    AVFrame *in = NULL;
+    int ret, status;
+    int64_t pts;
+
+    FF_FILTER_FORWARD_STATUS_BACK(outlink, inlink);
+
+    ret = ff_inlink_consume_samples(inlink, s->window_samples, s->window_samples, &in);
+    if (ret < 0)
+        return ret;
+
+    if (ret > 0) {
+        return filter_frame(inlink, in);
+    } else if (ff_inlink_acknowledge_status(inlink, &status, &pts)) {
+        ff_outlink_set_status(outlink, status, pts);
+        return 0;
+    } else {
+        if (ff_inlink_queued_samples(inlink) >= s->window_samples) {
+            ff_filter_set_ready(ctx, 10);
+        } else if (ff_outlink_frame_wanted(outlink)) {
+            ff_inlink_request_frame(inlink);
+        }
+        return 0;
+    }
+}
+
+static av_cold int init(AVFilterContext *ctx)
+{
+    AudioAnalysisContext *s = ctx->priv;
+
+    s->fdsp = avpriv_float_dsp_alloc(0);
+    if (!s->fdsp)
+        return AVERROR(ENOMEM);
+
+    return 0;
+}
+
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    AudioAnalysisContext *s = ctx->priv;
+
+    if (s->silence_reported)
+        report_silence_end(ctx, NULL);
+
+    av_tx_uninit(&s->tx);
+    av_freep(&s->mono);
+    av_freep(&s->tmp);
+    av_freep(&s->win);
+    av_freep(&s->windowed);
+    av_freep(&s->spectrum);
+    av_freep(&s->fdsp);
+}
+
+static const AVFilterPad inputs[] = {
+    {
+        .name         = "default",
+        .type         = AVMEDIA_TYPE_AUDIO,
+        .config_props = config_input,
+    },
+};
+
+const AVFilter ff_af_aanalysis = {
+    .name          = "aanalysis",
+    .description   = NULL_IF_CONFIG_SMALL("Measure level, detect silence and fingerprint audio."),
+    .priv_size     = sizeof(AudioAnalysisContext),
+    .priv_class    = &aanalysis_class,
+    .init          = init,
+    .uninit        = uninit,
+    .activate      = activate,
+    FILTER_INPUTS(inputs),
+    FILTER_OUTPUTS(ff_audio_default_filterpad),
+    FILTER_SINGLE_SAMPLEFMT(AV_SAMPLE_FMT_FLTP),
+};
@@ -144,6 +144,14 @@ static int config_output(AVFilterLink *outlink)
     if (ret < 0)
         return ret;
 
+    /* the generic threads option shadows the one of the resampler,
+     * forward it when it is set explicitly */
+    if (ctx->nb_threads > 0) {
+        ret = av_opt_set_int(aresample->swr, "threads", ff_filter_get_nb_threads(ctx), 0);
+        if (ret < 0)
+            return ret;
+    }
+
     ret = swr_init(aresample->swr);
     if (ret < 0)
         return ret;
@@ -27,6 +27,7 @@
 #include "internal.h"
 #include "audio.h"
 #include "ebur128.h"
+#include "af_loudnormdsp.h"
 
 enum FrameType {
     FIRST_FRAME,
@@ -51,6 +52,12 @@ enum PrintFormat {
     PF_NB
 };
 
+enum Precision {
+    PRECISION_DOUBLE,
+    PRECISION_FLOAT,
+    PRECISION_NB
+};
+
 typedef struct LoudNormContext {
     const AVClass *class;
     double target_i;
@@ -64,6 +71,7 @@ typedef struct LoudNormContext {
     int linear;
     int dual_mono;
     enum PrintFormat print_format;
+    enum Precision precision;
 
     double *buf;
     int buf_size;
@@ -95,6 +103,8 @@ typedef struct LoudNormContext {
 
     FFEBUR128State *r128_in;
     FFEBUR128State *r128_out;
+
+    LoudNormDSPContext dsp;
 } LoudNormContext;
 
 #define OFFSET(x) offsetof(LoudNormContext, x)
@@ -121,6 +131,9 @@ static const AVOption loudnorm_options[] = {
     {     "none",         0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  NONE},     0,         0,  FLAGS, .unit = "print_format" },
     {     "json",         0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  JSON},     0,         0,  FLAGS, .unit = "print_format" },
     {     "summary",      0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  SUMMARY},  0,         0,  FLAGS, .unit = "print_format" },
+    { "precision",        "set loudness measurement precision", OFFSET(precision),       AV_OPT_TYPE_INT,     {.i64 =  PRECISION_DOUBLE}, 0, PRECISION_NB-1, FLAGS, .unit = "precision" },
+    {     "double",       0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  PRECISION_DOUBLE}, 0, 0,  FLAGS, .unit = "precision" },
+    {     "float",        0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  PRECISION_FLOAT},  0, 0,  FLAGS, .unit = "precision" },
     { NULL }
 };
 
@@ -166,6 +179,24 @@ static double gaussian_filter(LoudNormContext *s, int index)
     return result;
 }
 
+static double max_peak(FFEBUR128State *st)
+{
+    const int true_peak = (st->mode & FF_EBUR128_MODE_TRUE_PEAK) == FF_EBUR128_MODE_TRUE_PEAK;
+    double peak = 0.;
+
+    for (int c = 0; c < st->channels; c++) {
+        double tmp;
+
+        if (true_peak)
+            ff_ebur128_true_peak(st, c, &tmp);
+        else
+            ff_ebur128_sample_peak(st, c, &tmp);
+        peak = FFMAX(peak, tmp);
+    }
+
+    return peak;
+}
+
 static void detect_peak(LoudNormContext *s, int offset, int nb_samples, int channels, int *peak_delta, double *peak_value)
 {
     int n, c, i, index;
@@ -185,6 +216,26 @@ static void detect_peak(LoudNormContext *s, int offset, int nb_samples, int chan
             s->prev_smp[c] = fabs(buf[index + c - channels]);
     }
 
+    if (nb_samples > 0) {
+        int len  = nb_samples * channels;
+        int len0 = FFMIN(len, s->limiter_buf_size - index);
+        double max = s->dsp.max_abs(buf + index, len0);
+
+        if (len0 < len)
+            max = FFMAX(max, s->dsp.max_abs(buf, len - len0));
+
+        /* no sample exceeds the ceiling, so no peak can be detected */
+        if (max <= ceiling) {
+            int last = index + len - channels;
+
+            if (last >= s->limiter_buf_size)
+                last -= s->limiter_buf_size;
+            for (c = 0; c < channels; c++)
+                s->prev_smp[c] = fabs(buf[last + c]);
+            return;
+        }
+    }
+
     for (n = 0; n < nb_samples; n++) {
         for (c = 0; c < channels; c++) {
             double this, next, max_peak;
@@ -447,12 +498,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
         double offset, offset_tp, true_peak;
 
         ff_ebur128_loudness_global(s->r128_in, &global);
-        for (c = 0; c < inlink->ch_layout.nb_channels; c++) {
-            double tmp;
-            ff_ebur128_sample_peak(s->r128_in, c, &tmp);
-            if (c == 0 || tmp > true_peak)
-                true_peak = tmp;
-        }
+        true_peak = max_peak(s->r128_in);
 
         offset    = pow(10., (s->target_i - global) / 20.);
         offset_tp = true_peak * offset;
@@ -755,12 +801,20 @@ static int config_input(AVFilterLink *inlink)
 {
     AVFilterContext *ctx = inlink->dst;
     LoudNormContext *s = ctx->priv;
+    int r128_mode = FF_EBUR128_MODE_I | FF_EBUR128_MODE_S | FF_EBUR128_MODE_LRA | FF_EBUR128_MODE_SAMPLE_PEAK;
 
-    s->r128_in = ff_ebur128_init(inlink->ch_layout.nb_channels, inlink->sample_rate, 0, FF_EBUR128_MODE_I | FF_EBUR128_MODE_S | FF_EBUR128_MODE_LRA | FF_EBUR128_MODE_SAMPLE_PEAK);
+    if (s->precision == PRECISION_FLOAT)
+        r128_mode |= FF_EBUR128_MODE_FLOAT;
+    /* in dynamic mode the input is already at 192 kHz, where the sample
+     * peak is the true peak */
+    if (inlink->sample_rate < 192000)
+        r128_mode |= FF_EBUR128_MODE_TRUE_PEAK;
+
+    s->r128_in = ff_ebur128_init(inlink->ch_layout.nb_channels, inlink->sample_rate, 0, r128_mode);
     if (!s->r128_in)
         return AVERROR(ENOMEM);
 
-    s->r128_out = ff_ebur128_init(inlink->ch_layout.nb_channels, inlink->sample_rate, 0, FF_EBUR128_MODE_I | FF_EBUR128_MODE_S | FF_EBUR128_MODE_LRA | FF_EBUR128_MODE_SAMPLE_PEAK);
+    s->r128_out = ff_ebur128_init(inlink->ch_layout.nb_channels, inlink->sample_rate, 0, r128_mode);
     if (!s->r128_out)
         return AVERROR(ENOMEM);
 
@@ -784,6 +838,7 @@ static int config_input(AVFilterLink *inlink)
         return AVERROR(ENOMEM);
 
     init_gaussian_filter(s);
+    ff_loudnorm_init(&s->dsp);
 
     s->buf_index =
     s->prev_buf_index =
@@ -824,7 +879,6 @@ static av_cold void uninit(AVFilterContext *ctx)
 {
     LoudNormContext *s = ctx->priv;
     double i_in, i_out, lra_in, lra_out, thresh_in, thresh_out, tp_in, tp_out;
-    int c;
 
     if (!s->r128_in || !s->r128_out)
         goto end;
@@ -832,22 +886,12 @@ static av_cold void uninit(AVFilterContext *ctx)
     ff_ebur128_loudness_range(s->r128_in, &lra_in);
     ff_ebur128_loudness_global(s->r128_in, &i_in);
     ff_ebur128_relative_threshold(s->r128_in, &thresh_in);
-    for (c = 0; c < s->channels; c++) {
-        double tmp;
-        ff_ebur128_sample_peak(s->r128_in, c, &tmp);
-        if ((c == 0) || (tmp > tp_in))
-            tp_in = tmp;
-    }
+    tp_in = max_peak(s->r128_in);
 
     ff_ebur128_loudness_range(s->r128_out, &lra_out);
     ff_ebur128_loudness_global(s->r128_out, &i_out);
     ff_ebur128_relative_threshold(s->r128_out, &thresh_out);
-    for (c = 0; c < s->channels; c++) {
-        double tmp;
-        ff_ebur128_sample_peak(s->r128_out, c, &tmp);
-        if ((c == 0) || (tmp > tp_out))
-            tp_out = tmp;
-    }
+    tp_out = max_peak(s->r128_out);
 
     switch(s->print_format) {
     case NONE:
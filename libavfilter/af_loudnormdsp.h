@@ -0,0 +1,167 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_LOUDNORMDSP_H
+#define AVFILTER_LOUDNORMDSP_H
+
+#include <math.h>
+#include <stddef.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/macros.h"
+
+/**
+ * Number of coefficients of the K-weighting filter: b0, b1, b2, a1, a2 of
+ * the shelving stage followed by the same for the high-pass stage.
+ */
+#define LOUDNORM_KWEIGHT_COEFFS 10
+
+/**
+ * Number of times each K-weighting coefficient is repeated, the widest
+ * vector of floats any version loads them as.
+ */
+#define LOUDNORM_KWEIGHT_WIDTH 8
+
+/**
+ * All functions operating on interleaved audio process the channels in
+ * parallel, so the channel count (which is also the stride between two
+ * sample frames) must be a multiple of channel_align and the buffers must
+ * be aligned to channel_align floats.
+ */
+typedef struct LoudNormDSPContext {
+    /**
+     * Apply the K-weighting filter as two cascaded biquads in transposed
+     * direct form II.
+     *
+     * @param coeffs   LOUDNORM_KWEIGHT_COEFFS coefficients, each repeated
+     *                 LOUDNORM_KWEIGHT_WIDTH times
+     * @param state    filter state, 4 rows of channels values
+     */
+    void (*kweight)(float *dst, const float *src, float *state,
+                    const float *coeffs, ptrdiff_t channels, ptrdiff_t len);
+
+    /**
+     * Add the energy (sum of squares) of each channel to sum.
+     */
+    void (*energy)(double *sum, const float *src, ptrdiff_t channels,
+                   ptrdiff_t len);
+
+    /**
+     * Update the per-channel absolute sample peak.
+     */
+    void (*peak)(float *peak, const float *src, ptrdiff_t channels,
+                 ptrdiff_t len);
+
+    /**
+     * Return the largest absolute value of len samples, or 0 if len is 0.
+     */
+    double (*max_abs)(const double *src, ptrdiff_t len);
+
+    /**
+     * Channel count multiple the functions above require, 4 or 8.
+     */
+    int channel_align;
+} LoudNormDSPContext;
+
+void ff_loudnorm_init_x86(LoudNormDSPContext *dsp);
+
+static void kweight_c(float *dst, const float *src, float *state,
+                      const float *coeffs, ptrdiff_t channels, ptrdiff_t len)
+{
+    const int w = LOUDNORM_KWEIGHT_WIDTH;
+    const float b0 = coeffs[0 * w], b1 = coeffs[1 * w], b2 = coeffs[2 * w];
+    const float a1 = coeffs[3 * w], a2 = coeffs[4 * w];
+    const float c0 = coeffs[5 * w], c1 = coeffs[6 * w], c2 = coeffs[7 * w];
+    const float d1 = coeffs[8 * w], d2 = coeffs[9 * w];
+
+    for (ptrdiff_t c = 0; c < channels; c++) {
+        float s0 = state[c];
+        float s1 = state[c + channels];
+        float s2 = state[c + channels * 2];
+        float s3 = state[c + channels * 3];
+
+        for (ptrdiff_t n = 0; n < len; n++) {
+            const float x = src[n * channels + c];
+            const float y = b0 * x + s0;
+            const float z = c0 * y + s2;
+
+            s0 = b1 * x - a1 * y + s1;
+            s1 = b2 * x - a2 * y;
+            s2 = c1 * y - d1 * z + s3;
+            s3 = c2 * y - d2 * z;
+            dst[n * channels + c] = z;
+        }
+
+        state[c]                = s0;
+        state[c + channels]     = s1;
+        state[c + channels * 2] = s2;
+        state[c + channels * 3] = s3;
+    }
+}
+
+static void energy_c(double *sum, const float *src, ptrdiff_t channels,
+                     ptrdiff_t len)
+{
+    for (ptrdiff_t c = 0; c < channels; c++) {
+        double acc = 0.0;
+
+        for (ptrdiff_t n = 0; n < len; n++) {
+            const double v = src[n * channels + c];
+            acc += v * v;
+        }
+        sum[c] += acc;
+    }
+}
+
+static void peak_c(float *peak, const float *src, ptrdiff_t channels,
+                   ptrdiff_t len)
+{
+    for (ptrdiff_t c = 0; c < channels; c++) {
+        float max = peak[c];
+
+        for (ptrdiff_t n = 0; n < len; n++)
+            max = FFMAX(max, fabsf(src[n * channels + c]));
+        peak[c] = max;
+    }
+}
+
+static double max_abs_c(const double *src, ptrdiff_t len)
+{
+    double max = 0.0;
+
+    for (ptrdiff_t n = 0; n < len; n++)
+        max = FFMAX(max, fabs(src[n]));
+
+    return max;
+}
+
+static av_unused void ff_loudnorm_init(LoudNormDSPContext *dsp)
+{
+    dsp->kweight = kweight_c;
+    dsp->energy  = energy_c;
+    dsp->peak    = peak_c;
+    dsp->max_abs = max_abs_c;
+    dsp->channel_align = 4;
+
+#if ARCH_X86
+    ff_loudnorm_init_x86(dsp);
+#endif
+}
+
+#endif /* AVFILTER_LOUDNORMDSP_H */
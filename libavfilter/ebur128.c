@@ -42,10 +42,13 @@
 */
 
 #include "ebur128.h"
+#include "af_loudnormdsp.h"
+#include "truepeak.h"
 
 #include <float.h>
 #include <limits.h>
 #include <math.h>               /* You may have to define _USE_MATH_DEFINES if you use MSVC */
+#include <string.h>
 
 #include "libavutil/error.h"
 #include "libavutil/macros.h"
@@ -97,6 +100,27 @@ struct FFEBUR128StateInternal {
     unsigned long window;
     /** Data pointer array for interleaved data */
     void **data_ptrs;
+
+    /** Single precision path, see FF_EBUR128_MODE_FLOAT. */
+    LoudNormDSPContext dsp;
+    /** Channel count padded to dsp.channel_align, stride of the buffers below. */
+    int padded_channels;
+    /** Filtered audio data (used as ring buffer). */
+    float *audio_data_f;
+    /** Input converted to single precision. */
+    float *src_f;
+    /** K-weighting filter state. */
+    float *filter_state_f;
+    /** Maximum sample peak, one per channel */
+    float *sample_peak_f;
+    /** Channel energies of the current block. */
+    double *energy_f;
+    /** Over-sampling context for true peak measurement. */
+    FFTruePeakContext tp;
+    /** Maximum true peak, one per channel */
+    double *true_peak;
+    /** K-weighting filter coefficients, each repeated LOUDNORM_KWEIGHT_WIDTH times. */
+    DECLARE_ALIGNED(32, float, coeffs_f)[LOUDNORM_KWEIGHT_COEFFS][LOUDNORM_KWEIGHT_WIDTH];
 };
 
 static AVOnce histogram_init = AV_ONCE_INIT;
@@ -146,6 +170,21 @@ static void ebur128_init_filter(FFEBUR128State * st)
     st->d->a[3] = pa[1] * ra[2] + pa[2] * ra[1];
     st->d->a[4] = pa[2] * ra[2];
 
+    /* the single precision path keeps the two stages separate, as the
+     * combined 4th order filter is not stable enough in float */
+    for (i = 0; i < LOUDNORM_KWEIGHT_WIDTH; i++) {
+        st->d->coeffs_f[0][i] = pb[0];
+        st->d->coeffs_f[1][i] = pb[1];
+        st->d->coeffs_f[2][i] = pb[2];
+        st->d->coeffs_f[3][i] = pa[1];
+        st->d->coeffs_f[4][i] = pa[2];
+        st->d->coeffs_f[5][i] = rb[0];
+        st->d->coeffs_f[6][i] = rb[1];
+        st->d->coeffs_f[7][i] = rb[2];
+        st->d->coeffs_f[8][i] = ra[1];
+        st->d->coeffs_f[9][i] = ra[2];
+    }
+
     for (i = 0; i < 5; ++i) {
         for (j = 0; j < 5; ++j) {
             st->d->v[i][j] = 0.0;
@@ -226,7 +265,7 @@ FFEBUR128State *ff_ebur128_init(unsigned int channels,
     st = (FFEBUR128State *) av_malloc(sizeof(*st));
     CHECK_ERROR(!st, 0, exit)
     st->d = (struct FFEBUR128StateInternal *)
-        av_malloc(sizeof(*st->d));
+        av_mallocz(sizeof(*st->d));
     CHECK_ERROR(!st->d, 0, free_state)
     st->channels = channels;
     errcode = ebur128_init_channel_map(st);
@@ -253,9 +292,15 @@ FFEBUR128State *ff_ebur128_init(unsigned int channels,
             + st->d->samples_in_100ms
             - (st->d->audio_data_frames % st->d->samples_in_100ms);
     }
-    st->d->audio_data =
-        (double *) av_calloc(st->d->audio_data_frames,
-                             st->channels * sizeof(*st->d->audio_data));
+    if (mode & FF_EBUR128_MODE_FLOAT) {
+        /* the double precision buffer is not used, but the error path
+         * below expects it to be allocated */
+        st->d->audio_data = av_malloc(sizeof(*st->d->audio_data));
+    } else {
+        st->d->audio_data =
+            (double *) av_calloc(st->d->audio_data_frames,
+                                 st->channels * sizeof(*st->d->audio_data));
+    }
     CHECK_ERROR(!st->d->audio_data, 0, free_sample_peak)
 
     ebur128_init_filter(st);
@@ -281,6 +326,35 @@ FFEBUR128State *ff_ebur128_init(unsigned int channels,
     CHECK_ERROR(!st->d->data_ptrs, 0,
                 free_short_term_block_energy_histogram);
 
+    if (mode & FF_EBUR128_MODE_FLOAT) {
+        int pch;
+
+        ff_loudnorm_init(&st->d->dsp);
+        pch = FFALIGN(channels, st->d->dsp.channel_align);
+        st->d->padded_channels = pch;
+        st->d->audio_data_f    = av_calloc(st->d->audio_data_frames,
+                                           pch * sizeof(*st->d->audio_data_f));
+        st->d->src_f           = av_calloc(st->d->samples_in_100ms * 4,
+                                           pch * sizeof(*st->d->src_f));
+        st->d->filter_state_f  = av_calloc(4 * pch, sizeof(*st->d->filter_state_f));
+        st->d->sample_peak_f   = av_calloc(pch, sizeof(*st->d->sample_peak_f));
+        st->d->energy_f        = av_calloc(pch, sizeof(*st->d->energy_f));
+        if (!st->d->audio_data_f || !st->d->src_f || !st->d->filter_state_f ||
+            !st->d->sample_peak_f || !st->d->energy_f) {
+            ff_ebur128_destroy(&st);
+            return NULL;
+        }
+    }
+
+    if ((mode & FF_EBUR128_MODE_TRUE_PEAK) == FF_EBUR128_MODE_TRUE_PEAK) {
+        st->d->true_peak = av_calloc(channels, sizeof(*st->d->true_peak));
+        if (!st->d->true_peak ||
+            ff_truepeak_init(&st->d->tp, channels, samplerate) < 0) {
+            ff_ebur128_destroy(&st);
+            return NULL;
+        }
+    }
+
     return st;
 
 free_short_term_block_energy_histogram:
@@ -309,6 +383,13 @@ void ff_ebur128_destroy(FFEBUR128State ** st)
     av_free((*st)->d->channel_map);
     av_free((*st)->d->sample_peak);
     av_free((*st)->d->data_ptrs);
+    av_free((*st)->d->audio_data_f);
+    av_free((*st)->d->src_f);
+    av_free((*st)->d->filter_state_f);
+    av_free((*st)->d->sample_peak_f);
+    av_free((*st)->d->energy_f);
+    av_free((*st)->d->true_peak);
+    ff_truepeak_uninit(&(*st)->d->tp);
     av_free((*st)->d);
     av_free(*st);
     *st = NULL;
@@ -365,6 +446,50 @@ static void ebur128_filter_##type(FFEBUR128State* st, const type** srcs,
 }
 EBUR128_FILTER(double, 1.0)
 
+static void ebur128_filter_float(FFEBUR128State *st, const double **srcs,
+                                 size_t src_index, size_t frames, int stride)
+{
+    struct FFEBUR128StateInternal *d = st->d;
+    const int pch = d->padded_channels;
+    float *src = d->src_f;
+    float *dst = d->audio_data_f + d->audio_data_index / st->channels * pch;
+    size_t i, c;
+
+    for (i = 0; i < frames; i++)
+        for (c = 0; c < st->channels; c++)
+            src[i * pch + c] = srcs[c][src_index + i * stride];
+
+    if ((st->mode & FF_EBUR128_MODE_SAMPLE_PEAK) == FF_EBUR128_MODE_SAMPLE_PEAK) {
+        d->dsp.peak(d->sample_peak_f, src, pch, frames);
+        for (c = 0; c < st->channels; c++)
+            d->sample_peak[c] = FFMAX(d->sample_peak[c], d->sample_peak_f[c]);
+    }
+
+    d->dsp.kweight(dst, src, d->filter_state_f, &d->coeffs_f[0][0], pch, frames);
+    for (i = 0; i < 4 * pch; i++)
+        if (fabsf(d->filter_state_f[i]) < FLT_MIN)
+            d->filter_state_f[i] = 0.0f;
+}
+
+static void ebur128_energy_float(FFEBUR128State *st, size_t frames_per_block)
+{
+    struct FFEBUR128StateInternal *d = st->d;
+    const int pch = d->padded_channels;
+    size_t index = d->audio_data_index / st->channels;
+
+    memset(d->energy_f, 0, pch * sizeof(*d->energy_f));
+    if (index < frames_per_block) {
+        if (index)
+            d->dsp.energy(d->energy_f, d->audio_data_f, pch, index);
+        d->dsp.energy(d->energy_f,
+                      d->audio_data_f + (d->audio_data_frames - (frames_per_block - index)) * pch,
+                      pch, frames_per_block - index);
+    } else {
+        d->dsp.energy(d->energy_f, d->audio_data_f + (index - frames_per_block) * pch,
+                      pch, frames_per_block);
+    }
+}
+
 static double ebur128_energy_to_loudness(double energy)
 {
     return 10 * log10(energy) - 0.691;
@@ -395,11 +520,17 @@ static void ebur128_calc_gating_block(FFEBUR128State * st,
     size_t i, c;
     double sum = 0.0;
     double channel_sum;
+
+    if (st->mode & FF_EBUR128_MODE_FLOAT)
+        ebur128_energy_float(st, frames_per_block);
+
     for (c = 0; c < st->channels; ++c) {
         if (st->d->channel_map[c] == FF_EBUR128_UNUSED)
             continue;
         channel_sum = 0.0;
-        if (st->d->audio_data_index < frames_per_block * st->channels) {
+        if (st->mode & FF_EBUR128_MODE_FLOAT) {
+            channel_sum = st->d->energy_f[c];
+        } else if (st->d->audio_data_index < frames_per_block * st->channels) {
             for (i = 0; i < st->d->audio_data_index / st->channels; ++i) {
                 channel_sum += st->d->audio_data[i * st->channels + c] *
                     st->d->audio_data[i * st->channels + c];
@@ -457,13 +588,22 @@ int ff_ebur128_set_channel(FFEBUR128State * st,
 }
 
 static int ebur128_energy_shortterm(FFEBUR128State * st, double *out);
+static void ebur128_filter(FFEBUR128State *st, const double **srcs,
+                           size_t src_index, size_t frames, int stride)
+{
+    if (st->mode & FF_EBUR128_MODE_FLOAT)
+        ebur128_filter_float(st, srcs, src_index, frames, stride);
+    else
+        ebur128_filter_double(st, srcs, src_index, frames, stride);
+}
+
 #define EBUR128_ADD_FRAMES_PLANAR(type)                                                \
 static void ebur128_add_frames_planar_##type(FFEBUR128State* st, const type** srcs,    \
                                  size_t frames, int stride) {                          \
     size_t src_index = 0;                                                              \
     while (frames > 0) {                                                               \
         if (frames >= st->d->needed_frames) {                                          \
-            ebur128_filter_##type(st, srcs, src_index, st->d->needed_frames, stride);  \
+            ebur128_filter(st, srcs, src_index, st->d->needed_frames, stride);         \
             src_index += st->d->needed_frames * stride;                                \
             frames -= st->d->needed_frames;                                            \
             st->d->audio_data_index += st->d->needed_frames * st->channels;            \
@@ -490,7 +630,7 @@ static void ebur128_add_frames_planar_##type(FFEBUR128State* st, const type** sr
                 st->d->audio_data_index = 0;                                           \
             }                                                                          \
         } else {                                                                       \
-            ebur128_filter_##type(st, srcs, src_index, frames, stride);                \
+            ebur128_filter(st, srcs, src_index, frames, stride);                       \
             st->d->audio_data_index += frames * st->channels;                          \
             if ((st->mode & FF_EBUR128_MODE_LRA) == FF_EBUR128_MODE_LRA) {             \
                 st->d->short_term_frame_counter += frames;                             \
@@ -508,6 +648,8 @@ void ff_ebur128_add_frames_##type(FFEBUR128State* st, const type* src,         \
   const type **buf = (const type**)st->d->data_ptrs;                           \
   for (i = 0; i < st->channels; i++)                                           \
     buf[i] = src + i;                                                          \
+  if ((st->mode & FF_EBUR128_MODE_TRUE_PEAK) == FF_EBUR128_MODE_TRUE_PEAK)     \
+    ff_truepeak_process(&st->d->tp, st->d->true_peak, src, frames);            \
   ebur128_add_frames_planar_##type(st, buf, frames, st->channels);             \
 }
 FF_EBUR128_ADD_FRAMES(double)
@@ -723,3 +865,16 @@ int ff_ebur128_sample_peak(FFEBUR128State * st,
     *out = st->d->sample_peak[channel_number];
     return 0;
 }
+
+int ff_ebur128_true_peak(FFEBUR128State * st,
+                         unsigned int channel_number, double *out)
+{
+    if ((st->mode & FF_EBUR128_MODE_TRUE_PEAK) !=
+        FF_EBUR128_MODE_TRUE_PEAK) {
+        return AVERROR(EINVAL);
+    } else if (channel_number >= st->channels) {
+        return AVERROR(EINVAL);
+    }
+    *out = st->d->true_peak[channel_number];
+    return 0;
+}
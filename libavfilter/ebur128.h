@@ -91,6 +91,11 @@ enum mode {
     FF_EBUR128_MODE_LRA = (1 << 3) | FF_EBUR128_MODE_S,
   /** can call ff_ebur128_sample_peak */
     FF_EBUR128_MODE_SAMPLE_PEAK = (1 << 4) | FF_EBUR128_MODE_M,
+  /** filter and accumulate energy in single precision, which is faster but
+   *  slightly less accurate */
+    FF_EBUR128_MODE_FLOAT = (1 << 5),
+  /** can call ff_ebur128_true_peak */
+    FF_EBUR128_MODE_TRUE_PEAK = (1 << 6) | FF_EBUR128_MODE_SAMPLE_PEAK,
 };
 
 /** forward declaration of FFEBUR128StateInternal */
@@ -216,6 +221,22 @@ int ff_ebur128_loudness_range_multiple(FFEBUR128State ** sts,
 int ff_ebur128_sample_peak(FFEBUR128State * st,
                            unsigned int channel_number, double *out);
 
+/** \brief Get maximum true peak of selected channel in float format.
+ *
+ *  The signal is over-sampled 4 times below 96 kHz and 2 times below
+ *  192 kHz, as described in ITU-R BS.1770-4 Annex 2.
+ *
+ *  @param st library state
+ *  @param channel_number channel to analyse
+ *  @param out maximum true peak in float format (1.0 is 0 dBFS)
+ *  @return
+ *    - 0 on success.
+ *    - AVERROR(EINVAL) if mode "FF_EBUR128_MODE_TRUE_PEAK" has not been set.
+ *    - AVERROR(EINVAL) if invalid channel index.
+ */
+int ff_ebur128_true_peak(FFEBUR128State * st,
+                         unsigned int channel_number, double *out);
+
 /** \brief Get relative threshold in LUFS.
  *
  *  @param st library state
@@ -0,0 +1,155 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * True-peak measurement by polyphase oversampling, ITU-R BS.1770-4 Annex 2
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/error.h"
+#include "libavutil/macros.h"
+#include "libavutil/mem.h"
+#include "truepeak.h"
+
+#define BLOCK_SIZE 1024
+#define BUF_STRIDE (TRUEPEAK_TAPS - 1 + BLOCK_SIZE)
+
+/* 48-tap interpolating FIR, split into its 4 phases */
+static const double truepeak_coeffs[4][TRUEPEAK_TAPS] = {
+    {  0.0017089843750,  0.0109863281250, -0.0196533203125,  0.0332031250000,
+      -0.0594482421875,  0.1373291015625,  0.9721679687500, -0.1022949218750,
+       0.0476074218750, -0.0266113281250,  0.0148925781250, -0.0083007812500 },
+    { -0.0291748046875,  0.0292968750000, -0.0517578125000,  0.0891113281250,
+      -0.1665039062500,  0.4650878906250,  0.7797851562500, -0.2003173828125,
+       0.1015625000000, -0.0582275390625,  0.0330810546875, -0.0189208984375 },
+    { -0.0189208984375,  0.0330810546875, -0.0582275390625,  0.1015625000000,
+      -0.2003173828125,  0.7797851562500,  0.4650878906250, -0.1665039062500,
+       0.0891113281250, -0.0517578125000,  0.0292968750000, -0.0291748046875 },
+    { -0.0083007812500,  0.0148925781250, -0.0266113281250,  0.0476074218750,
+      -0.1022949218750,  0.9721679687500,  0.1373291015625, -0.0594482421875,
+       0.0332031250000, -0.0196533203125,  0.0109863281250,  0.0017089843750 },
+};
+
+static double upsample_max_c(const double *src, const double *coeffs,
+                             ptrdiff_t len)
+{
+    const double *c0 = coeffs;
+    const double *c1 = coeffs + TRUEPEAK_TAPS * 4;
+    double max = 0.0;
+
+    for (ptrdiff_t n = 0; n < len; n++) {
+        double y0 = 0.0, y1 = 0.0;
+
+        for (int k = 0; k < TRUEPEAK_TAPS; k++) {
+            y0 += c0[k * 4] * src[n + k];
+            y1 += c1[k * 4] * src[n + k];
+        }
+        max = FFMAX(max, fabs(y0));
+        max = FFMAX(max, fabs(y1));
+    }
+
+    return max;
+}
+
+av_cold void ff_truepeak_dsp_init(TruePeakDSPContext *dsp)
+{
+    dsp->upsample_max = upsample_max_c;
+
+#if ARCH_X86
+    ff_truepeak_dsp_init_x86(dsp);
+#endif
+}
+
+av_cold int ff_truepeak_init(FFTruePeakContext *s, int channels, int sample_rate)
+{
+    s->channels = channels;
+    s->factor   = sample_rate < 96000 ? 4 : sample_rate < 192000 ? 2 : 1;
+
+    /* with 2x oversampling only the phases at 0 and 1/2 are needed */
+    for (int p = 0; p < s->factor; p++) {
+        const double *phase = truepeak_coeffs[p * 4 / s->factor];
+
+        for (int k = 0; k < TRUEPEAK_TAPS; k++)
+            for (int i = 0; i < 4; i++)
+                s->coeffs[p][k][i] = phase[k];
+    }
+
+    s->buf = av_calloc(channels, BUF_STRIDE * sizeof(*s->buf));
+    if (!s->buf)
+        return AVERROR(ENOMEM);
+
+    ff_truepeak_dsp_init(&s->dsp);
+
+    return 0;
+}
+
+static double upsample_max(FFTruePeakContext *s, const double *src, int len)
+{
+    const int len4 = len & ~3;
+    double max = 0.0;
+
+    if (s->factor == 1) {
+        for (int n = 0; n < len; n++)
+            max = FFMAX(max, fabs(src[TRUEPEAK_TAPS - 1 + n]));
+        return max;
+    }
+
+    for (int p = 0; p < s->factor; p += 2) {
+        const double *coeffs = &s->coeffs[p][0][0];
+
+        if (len4)
+            max = FFMAX(max, s->dsp.upsample_max(src, coeffs, len4));
+        if (len4 < len)
+            max = FFMAX(max, upsample_max_c(src + len4, coeffs, len - len4));
+    }
+
+    return max;
+}
+
+void ff_truepeak_process(FFTruePeakContext *s, double *peaks,
+                         const double *src, int nb_samples)
+{
+    const int channels = s->channels;
+
+    while (nb_samples > 0) {
+        const int len = FFMIN(nb_samples, BLOCK_SIZE);
+
+        for (int c = 0; c < channels; c++) {
+            double *buf = s->buf + c * BUF_STRIDE;
+
+            for (int n = 0; n < len; n++)
+                buf[TRUEPEAK_TAPS - 1 + n] = src[n * channels + c];
+
+            peaks[c] = FFMAX(peaks[c], upsample_max(s, buf, len));
+            memmove(buf, buf + len, (TRUEPEAK_TAPS - 1) * sizeof(*buf));
+        }
+
+        src        += len * channels;
+        nb_samples -= len;
+    }
+}
+
+av_cold void ff_truepeak_uninit(FFTruePeakContext *s)
+{
+    av_freep(&s->buf);
+}
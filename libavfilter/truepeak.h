@@ -0,0 +1,80 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * True-peak measurement by polyphase oversampling, ITU-R BS.1770-4 Annex 2
+ */
+
+#ifndef AVFILTER_TRUEPEAK_H
+#define AVFILTER_TRUEPEAK_H
+
+#include <stddef.h>
+
+#include "libavutil/mem_internal.h"
+
+/** Number of taps of each phase of the interpolation filter. */
+#define TRUEPEAK_TAPS 12
+
+typedef struct TruePeakDSPContext {
+    /**
+     * Interpolate two phases and return the largest absolute output value.
+     *
+     * For each n in [0, len) and each of the two phases p, computes
+     * sum(coeffs[p][k][0] * src[n + k]) over the TRUEPEAK_TAPS taps k.
+     *
+     * @param src    len + TRUEPEAK_TAPS - 1 input samples
+     * @param coeffs 2 x TRUEPEAK_TAPS coefficients, each repeated 4 times,
+     *               32-byte aligned
+     * @param len    number of input positions, must be a multiple of 4
+     */
+    double (*upsample_max)(const double *src, const double *coeffs,
+                           ptrdiff_t len);
+} TruePeakDSPContext;
+
+typedef struct FFTruePeakContext {
+    TruePeakDSPContext dsp;
+    int channels;
+    int factor;                 ///< oversampling factor: 1, 2 or 4
+    double *buf;                ///< per-channel history followed by input
+    DECLARE_ALIGNED(32, double, coeffs)[4][TRUEPEAK_TAPS][4];
+} FFTruePeakContext;
+
+void ff_truepeak_dsp_init(TruePeakDSPContext *dsp);
+void ff_truepeak_dsp_init_x86(TruePeakDSPContext *dsp);
+
+/**
+ * Set up true-peak measurement. The oversampling factor is 4 below 96 kHz,
+ * 2 below 192 kHz and 1 (sample peak) above.
+ *
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int ff_truepeak_init(FFTruePeakContext *s, int channels, int sample_rate);
+
+/**
+ * Measure interleaved samples.
+ *
+ * @param peaks per-channel peaks, updated with the maximum absolute value
+ *              of the oversampled signal
+ */
+void ff_truepeak_process(FFTruePeakContext *s, double *peaks,
+                         const double *src, int nb_samples);
+
+void ff_truepeak_uninit(FFTruePeakContext *s);
+
+#endif /* AVFILTER_TRUEPEAK_H */
@@ -0,0 +1,623 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * multi-output scale filter
+ *
+ * Scales one input into several outputs of different sizes and formats.
+ * Every output may be produced from the smallest previously scaled output
+ * that is still at least as large as itself (cascading), so the full
+ * resolution source is read only for the largest renditions.
+ */
+
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/avstring.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/parseutils.h"
+#include "libavutil/pixdesc.h"
+#include "libswscale/swscale.h"
+
+#include "avfilter.h"
+#include "filters.h"
+#include "formats.h"
+#include "internal.h"
+#include "scale_eval.h"
+#include "video.h"
+
+typedef struct MultiScaleOutput {
+    int req_w, req_h;           ///< requested size, <= 0 as in the scale filter
+    enum AVPixelFormat format;  ///< requested format or AV_PIX_FMT_NONE
+    struct SwsContext *sws;     ///< NULL if the source can be passed through
+    int src;                    ///< index of the source output, -1 for the input
+} MultiScaleOutput;
+
+typedef struct MultiScaleContext {
+    const AVClass *class;
+    struct SwsContext *sws_opts;
+
+    char *sizes_str;
+    char *formats_str;
+    char *flags_str;
+    double param[2];
+    int cascade;
+
+    MultiScaleOutput *outs;
+    int nb_outs;
+    AVFrame **frames;
+} MultiScaleContext;
+
+static const int sws_colorspaces[] = {
+    AVCOL_SPC_UNSPECIFIED,
+    AVCOL_SPC_RGB,
+    AVCOL_SPC_BT709,
+    AVCOL_SPC_BT470BG,
+    AVCOL_SPC_SMPTE170M,
+    AVCOL_SPC_FCC,
+    AVCOL_SPC_SMPTE240M,
+    AVCOL_SPC_BT2020_NCL,
+    -1
+};
+
+static av_cold int preinit(AVFilterContext *ctx)
+{
+    MultiScaleContext *s = ctx->priv;
+
+    s->sws_opts = sws_alloc_context();
+    if (!s->sws_opts)
+        return AVERROR(ENOMEM);
+
+    // set threads=0, so we can later check whether the user modified it
+    return av_opt_set_int(s->sws_opts, "threads", 0, 0);
+}
+
+static int parse_size(AVFilterContext *ctx, const char *str, int *w, int *h)
+{
+    char tail;
+
+    if (sscanf(str, "%dx%d%c", w, h, &tail) == 2)
+        return 0;
+    if (av_parse_video_size(w, h, str) >= 0)
+        return 0;
+
+    av_log(ctx, AV_LOG_ERROR, "Invalid size '%s'\n", str);
+    return AVERROR(EINVAL);
+}
+
+static int config_output(AVFilterLink *outlink);
+
+static av_cold int init(AVFilterContext *ctx)
+{
+    MultiScaleContext *s = ctx->priv;
+    char *sizes = NULL, *formats = NULL, *arg, *saveptr = NULL;
+    int64_t threads;
+    int ret = 0;
+
+    if (!s->sizes_str || !*s->sizes_str) {
+        av_log(ctx, AV_LOG_ERROR, "No output sizes specified.\n");
+        return AVERROR(EINVAL);
+    }
+
+    sizes = av_strdup(s->sizes_str);
+    if (!sizes)
+        return AVERROR(ENOMEM);
+
+    for (char *p = sizes; (arg = av_strtok(p, "|", &saveptr)); p = NULL) {
+        MultiScaleOutput *out;
+        AVFilterPad pad = { 0 };
+
+        out = av_dynarray2_add((void **)&s->outs, &s->nb_outs,
+                               sizeof(*s->outs), NULL);
+        if (!out) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        out->format = AV_PIX_FMT_NONE;
+        out->src    = -1;
+        out->sws    = NULL;
+
+        ret = parse_size(ctx, arg, &out->req_w, &out->req_h);
+        if (ret < 0)
+            goto end;
+
+        pad.type         = AVMEDIA_TYPE_VIDEO;
+        pad.config_props = config_output;
+        pad.name = av_asprintf("output%d", s->nb_outs - 1);
+        if (!pad.name) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        if ((ret = ff_append_outpad_free_name(ctx, &pad)) < 0)
+            goto end;
+    }
+
+    if (s->formats_str && *s->formats_str) {
+        int i = 0;
+
+        formats = av_strdup(s->formats_str);
+        if (!formats) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+
+        saveptr = NULL;
+        for (char *p = formats; (arg = av_strtok(p, "|", &saveptr)); p = NULL, i++) {
+            if (i >= s->nb_outs) {
+                av_log(ctx, AV_LOG_ERROR, "More formats than sizes specified.\n");
+                ret = AVERROR(EINVAL);
+                goto end;
+            }
+            if (!strcmp(arg, "auto"))
+                continue;
+            s->outs[i].format = av_get_pix_fmt(arg);
+            if (s->outs[i].format == AV_PIX_FMT_NONE ||
+                !sws_isSupportedOutput(s->outs[i].format)) {
+                av_log(ctx, AV_LOG_ERROR, "Unsupported output format '%s'\n", arg);
+                ret = AVERROR(EINVAL);
+                goto end;
+            }
+        }
+    }
+
+    s->frames = av_calloc(s->nb_outs, sizeof(*s->frames));
+    if (!s->frames) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    if (s->flags_str && *s->flags_str) {
+        ret = av_opt_set(s->sws_opts, "sws_flags", s->flags_str, 0);
+        if (ret < 0)
+            goto end;
+    }
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(s->param); i++)
+        if (s->param[i] != DBL_MAX) {
+            ret = av_opt_set_double(s->sws_opts, i ? "param1" : "param0",
+                                    s->param[i], 0);
+            if (ret < 0)
+                goto end;
+        }
+
+    // use generic thread-count if the user did not set it explicitly
+    ret = av_opt_get_int(s->sws_opts, "threads", 0, &threads);
+    if (ret < 0)
+        goto end;
+    if (!threads)
+        av_opt_set_int(s->sws_opts, "threads", ff_filter_get_nb_threads(ctx), 0);
+
+end:
+    av_free(sizes);
+    av_free(formats);
+    return ret;
+}
+
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    MultiScaleContext *s = ctx->priv;
+
+    for (int i = 0; i < s->nb_outs; i++) {
+        sws_freeContext(s->outs[i].sws);
+        if (s->frames)
+            av_frame_free(&s->frames[i]);
+    }
+    sws_freeContext(s->sws_opts);
+    av_freep(&s->outs);
+    av_freep(&s->frames);
+    s->nb_outs = 0;
+}
+
+static int sws_formats(AVFilterFormats **formats, int output)
+{
+    const AVPixFmtDescriptor *desc = NULL;
+    int ret;
+
+    while ((desc = av_pix_fmt_desc_next(desc))) {
+        enum AVPixelFormat pix_fmt = av_pix_fmt_desc_get_id(desc);
+        if ((output ? sws_isSupportedOutput(pix_fmt) : sws_isSupportedInput(pix_fmt)) &&
+            (ret = ff_add_format(formats, pix_fmt)) < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static int query_formats(AVFilterContext *ctx)
+{
+    MultiScaleContext *s = ctx->priv;
+    AVFilterFormats *formats = NULL;
+    int ret;
+
+    if ((ret = sws_formats(&formats, 0)) < 0 ||
+        (ret = ff_formats_ref(formats, &ctx->inputs[0]->outcfg.formats)) < 0)
+        return ret;
+
+    /* every output negotiates its format independently */
+    for (int i = 0; i < s->nb_outs; i++) {
+        formats = NULL;
+        if (s->outs[i].format != AV_PIX_FMT_NONE)
+            formats = ff_make_formats_list_singleton(s->outs[i].format);
+        else if ((ret = sws_formats(&formats, 1)) < 0)
+            return ret;
+        if ((ret = ff_formats_ref(formats, &ctx->outputs[i]->incfg.formats)) < 0)
+            return ret;
+    }
+
+    /* all renditions share the colorimetry of the input */
+    ret = ff_set_common_color_spaces(ctx, ff_make_format_list(sws_colorspaces));
+    if (ret < 0)
+        return ret;
+
+    return ff_set_common_all_color_ranges(ctx);
+}
+
+static int eval_output_size(AVFilterContext *ctx, int idx, int *w, int *h)
+{
+    MultiScaleContext *s = ctx->priv;
+    AVFilterLink *inlink = ctx->inputs[0];
+    int ret;
+
+    *w = s->outs[idx].req_w ? s->outs[idx].req_w : inlink->w;
+    *h = s->outs[idx].req_h ? s->outs[idx].req_h : inlink->h;
+
+    ret = ff_scale_adjust_dimensions(inlink, w, h, 0, 1);
+    if (ret < 0 || *w <= 0 || *h <= 0) {
+        av_log(ctx, AV_LOG_ERROR, "Invalid size for output %d: %dx%d\n",
+               idx, *w, *h);
+        return AVERROR(EINVAL);
+    }
+
+    return 0;
+}
+
+/**
+ * Check that scaling from a frame in format src does not lose anything
+ * that scaling from the filter input (format in) to format dst would keep:
+ * src must be in the same color family as dst, carry all of its components
+ * (including alpha), have no coarser chroma subsampling and no lower bit
+ * depth than either of them.
+ */
+static int is_cascade_source(const AVPixFmtDescriptor *src,
+                             const AVPixFmtDescriptor *dst,
+                             const AVPixFmtDescriptor *in)
+{
+    if ((src->flags & AV_PIX_FMT_FLAG_RGB) != (dst->flags & AV_PIX_FMT_FLAG_RGB))
+        return 0;
+    if (src->nb_components < dst->nb_components)
+        return 0;
+    if ((dst->flags & AV_PIX_FMT_FLAG_ALPHA) && !(src->flags & AV_PIX_FMT_FLAG_ALPHA))
+        return 0;
+    if (dst->nb_components > 2 &&
+        (src->log2_chroma_w > dst->log2_chroma_w ||
+         src->log2_chroma_h > dst->log2_chroma_h))
+        return 0;
+    /* never cascade through a lossy downconversion of bit depth */
+    if (src->comp[0].depth < dst->comp[0].depth ||
+        src->comp[0].depth < in->comp[0].depth)
+        return 0;
+    return 1;
+}
+
+/**
+ * Select the frame output idx is scaled from: the smallest earlier output
+ * that is at least as large as the target in both dimensions, can be fed
+ * back into libswscale and passes is_cascade_source(). Falls back to the
+ * filter input.
+ */
+static int select_source(AVFilterContext *ctx, int idx, int w, int h)
+{
+    MultiScaleContext *s = ctx->priv;
+    const AVPixFmtDescriptor *dst = av_pix_fmt_desc_get(ctx->outputs[idx]->format);
+    const AVPixFmtDescriptor *in  = av_pix_fmt_desc_get(ctx->inputs[0]->format);
+    int best = -1;
+    int64_t best_area = INT64_MAX;
+
+    if (!s->cascade)
+        return -1;
+
+    for (int j = 0; j < idx; j++) {
+        const AVFilterLink *link = ctx->outputs[j];
+        int jw, jh;
+
+        if (eval_output_size(ctx, j, &jw, &jh) < 0)
+            continue;
+        if (jw < w || jh < h || !sws_isSupportedInput(link->format))
+            continue;
+        if (!is_cascade_source(av_pix_fmt_desc_get(link->format), dst, in))
+            continue;
+        if ((int64_t)jw * jh < best_area) {
+            best      = j;
+            best_area = (int64_t)jw * jh;
+        }
+    }
+
+    return best;
+}
+
+static int config_output(AVFilterLink *outlink)
+{
+    AVFilterContext *ctx = outlink->src;
+    MultiScaleContext *s = ctx->priv;
+    AVFilterLink *inlink = ctx->inputs[0];
+    int idx = FF_OUTLINK_IDX(outlink);
+    MultiScaleOutput *out = &s->outs[idx];
+    const AVPixFmtDescriptor *outdesc = av_pix_fmt_desc_get(outlink->format);
+    const AVPixFmtDescriptor *srcdesc;
+    enum AVPixelFormat src_format;
+    int src_w, src_h, ret;
+
+    if ((ret = eval_output_size(ctx, idx, &outlink->w, &outlink->h)) < 0)
+        return ret;
+
+    out->src = select_source(ctx, idx, outlink->w, outlink->h);
+    if (out->src >= 0) {
+        if ((ret = eval_output_size(ctx, out->src, &src_w, &src_h)) < 0)
+            return ret;
+        src_format = ctx->outputs[out->src]->format;
+    } else {
+        src_w      = inlink->w;
+        src_h      = inlink->h;
+        src_format = inlink->format;
+    }
+    srcdesc = av_pix_fmt_desc_get(src_format);
+
+    sws_freeContext(out->sws);
+    out->sws = NULL;
+
+    if (src_w != outlink->w || src_h != outlink->h ||
+        src_format != outlink->format) {
+        int in_full, out_full, brightness, contrast, saturation;
+        const int *inv_table, *table;
+        struct SwsContext *sws = sws_alloc_context();
+        if (!sws)
+            return AVERROR(ENOMEM);
+        out->sws = sws;
+
+        ret = av_opt_copy(sws, s->sws_opts);
+        if (ret < 0)
+            return ret;
+
+        av_opt_set_int(sws, "srcw", src_w, 0);
+        av_opt_set_int(sws, "srch", src_h, 0);
+        av_opt_set_int(sws, "src_format", src_format, 0);
+        av_opt_set_int(sws, "dstw", outlink->w, 0);
+        av_opt_set_int(sws, "dsth", outlink->h, 0);
+        av_opt_set_int(sws, "dst_format", outlink->format, 0);
+        if (inlink->color_range != AVCOL_RANGE_UNSPECIFIED) {
+            av_opt_set_int(sws, "src_range",
+                           inlink->color_range == AVCOL_RANGE_JPEG, 0);
+            av_opt_set_int(sws, "dst_range",
+                           inlink->color_range == AVCOL_RANGE_JPEG, 0);
+        }
+
+        /* MPEG chroma positions are used by convention, see vf_scale */
+        if (srcdesc->log2_chroma_h == 1)
+            av_opt_set_int(sws, "src_v_chr_pos", 128, 0);
+        if (outdesc->log2_chroma_h == 1)
+            av_opt_set_int(sws, "dst_v_chr_pos", 128, 0);
+
+        if ((ret = sws_init_context(sws, NULL, NULL)) < 0)
+            return ret;
+
+        sws_getColorspaceDetails(sws, (int **)&inv_table, &in_full,
+                                 (int **)&table, &out_full,
+                                 &brightness, &contrast, &saturation);
+        inv_table = table = sws_getCoefficients(inlink->colorspace);
+        sws_setColorspaceDetails(sws, inv_table, in_full,
+                                 table, out_full,
+                                 brightness, contrast, saturation);
+    }
+
+    if (inlink->sample_aspect_ratio.num)
+        outlink->sample_aspect_ratio = av_mul_q((AVRational){ outlink->h * inlink->w,
+                                                              outlink->w * inlink->h },
+                                                inlink->sample_aspect_ratio);
+    else
+        outlink->sample_aspect_ratio = inlink->sample_aspect_ratio;
+
+    av_log(ctx, AV_LOG_VERBOSE, "output%d: %s w:%d h:%d fmt:%s -> w:%d h:%d fmt:%s\n",
+           idx, out->src >= 0 ? "cascaded from output" : "scaled from input",
+           src_w, src_h, av_get_pix_fmt_name(src_format),
+           outlink->w, outlink->h, av_get_pix_fmt_name(outlink->format));
+
+    return 0;
+}
+
+static int scale_outputs(AVFilterContext *ctx, AVFrame *in)
+{
+    MultiScaleContext *s = ctx->priv;
+    AVFilterLink *inlink = ctx->inputs[0];
+    int ret;
+
+    for (int i = 0; i < s->nb_outs; i++) {
+        AVFilterLink *outlink = ctx->outputs[i];
+        MultiScaleOutput *out = &s->outs[i];
+        AVFrame *src = out->src >= 0 ? s->frames[out->src] : in;
+        AVFrame *dst;
+
+        if (!out->sws) {
+            s->frames[i] = av_frame_clone(src);
+            if (!s->frames[i])
+                return AVERROR(ENOMEM);
+            continue;
+        }
+
+        dst = ff_get_video_buffer(outlink, outlink->w, outlink->h);
+        if (!dst)
+            return AVERROR(ENOMEM);
+        s->frames[i] = dst;
+
+        ret = av_frame_copy_props(dst, in);
+        if (ret < 0)
+            return ret;
+        dst->width       = outlink->w;
+        dst->height      = outlink->h;
+        dst->color_range = outlink->color_range;
+        dst->colorspace  = outlink->colorspace;
+        av_reduce(&dst->sample_aspect_ratio.num, &dst->sample_aspect_ratio.den,
+                  (int64_t)in->sample_aspect_ratio.num * outlink->h * inlink->w,
+                  (int64_t)in->sample_aspect_ratio.den * outlink->w * inlink->h,
+                  INT_MAX);
+
+        ret = sws_scale_frame(out->sws, dst, src);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static int filter_frame(AVFilterContext *ctx, AVFrame *in)
+{
+    MultiScaleContext *s = ctx->priv;
+    AVFilterLink *inlink = ctx->inputs[0];
+    int ret;
+
+    if (in->width  != inlink->w || in->height != inlink->h ||
+        in->format != inlink->format) {
+        av_log(ctx, AV_LOG_ERROR, "Input frame properties changed from "
+               "%dx%d %s to %dx%d %s, this is not supported.\n",
+               inlink->w, inlink->h, av_get_pix_fmt_name(inlink->format),
+               in->width, in->height, av_get_pix_fmt_name(in->format));
+        av_frame_free(&in);
+        return AVERROR(EINVAL);
+    }
+
+    ret = scale_outputs(ctx, in);
+    av_frame_free(&in);
+
+    /* the intermediate frames are only handed out once all of them have
+     * been produced, since later outputs may be scaled from earlier ones */
+    for (int i = 0; i < s->nb_outs; i++) {
+        AVFrame *frame = s->frames[i];
+
+        s->frames[i] = NULL;
+        if (ret < 0 || !frame || ff_outlink_get_status(ctx->outputs[i])) {
+            av_frame_free(&frame);
+            continue;
+        }
+        ret = ff_filter_frame(ctx->outputs[i], frame);
+    }
+
+    return ret;
+}
+
+static int activate(AVFilterContext *ctx)
+{
+    AVFilterLink *inlink = ctx->inputs[0];
+    AVFrame *in;
+    int status, ret, nb_eofs = 0;
+    int64_t pts;
+
+    for (int i = 0; i < ctx->nb_outputs; i++)
+        nb_eofs += ff_outlink_get_status(ctx->outputs[i]) == AVERROR_EOF;
+
+    if (nb_eofs == ctx->nb_outputs) {
+        ff_inlink_set_status(inlink, AVERROR_EOF);
+        return 0;
+    }
+
+    ret = ff_inlink_consume_frame(inlink, &in);
+    if (ret < 0)
+        return ret;
+    if (ret > 0) {
+        ret = filter_frame(ctx, in);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (ff_inlink_acknowledge_status(inlink, &status, &pts)) {
+        for (int i = 0; i < ctx->nb_outputs; i++) {
+            if (ff_outlink_get_status(ctx->outputs[i]))
+                continue;
+            ff_outlink_set_status(ctx->outputs[i], status, pts);
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < ctx->nb_outputs; i++) {
+        if (ff_outlink_get_status(ctx->outputs[i]))
+            continue;
+
+        if (ff_outlink_frame_wanted(ctx->outputs[i])) {
+            ff_inlink_request_frame(inlink);
+            return 0;
+        }
+    }
+
+    return FFERROR_NOT_READY;
+}
+
+static const AVClass *child_class_iterate(void **iter)
+{
+    const AVClass *c = *iter ? NULL : sws_get_class();
+    *iter = (void*)(uintptr_t)c;
+    return c;
+}
+
+static void *child_next(void *obj, void *prev)
+{
+    MultiScaleContext *s = obj;
+    if (!prev)
+        return s->sws_opts;
+    return NULL;
+}
+
+#define OFFSET(x) offsetof(MultiScaleContext, x)
+#define FLAGS AV_OPT_FLAG_VIDEO_PARAM|AV_OPT_FLAG_FILTERING_PARAM
+
+static const AVOption multiscale_options[] = {
+    { "sizes",   "set '|'-separated list of output sizes", OFFSET(sizes_str),   AV_OPT_TYPE_STRING, { .str = NULL }, .flags = FLAGS },
+    { "formats", "set '|'-separated list of output pixel formats", OFFSET(formats_str), AV_OPT_TYPE_STRING, { .str = NULL }, .flags = FLAGS },
+    { "cascade", "scale smaller outputs from larger ones", OFFSET(cascade), AV_OPT_TYPE_BOOL, { .i64 = 1 }, 0, 1, FLAGS },
+    { "flags",   "Flags to pass to libswscale", OFFSET(flags_str), AV_OPT_TYPE_STRING, { .str = "" }, .flags = FLAGS },
+    { "param0",  "Scaler param 0",              OFFSET(param[0]),  AV_OPT_TYPE_DOUBLE, { .dbl = DBL_MAX }, -DBL_MAX, DBL_MAX, FLAGS },
+    { "param1",  "Scaler param 1",              OFFSET(param[1]),  AV_OPT_TYPE_DOUBLE, { .dbl = DBL_MAX }, -DBL_MAX, DBL_MAX, FLAGS },
+    { NULL }
+};
+
+static const AVClass multiscale_class = {
+    .class_name          = "multiscale",
+    .item_name           = av_default_item_name,
+    .option              = multiscale_options,
+    .version             = LIBAVUTIL_VERSION_INT,
+    .category            = AV_CLASS_CATEGORY_FILTER,
+    .child_class_iterate = child_class_iterate,
+    .child_next          = child_next,
+};
+
+const AVFilter ff_vf_multiscale = {
+    .name          = "multiscale",
+    .description   = NULL_IF_CONFIG_SMALL("Scale the input video to multiple output sizes and/or formats."),
+    .preinit       = preinit,
+    .init          = init,
+    .uninit        = uninit,
+    .activate      = activate,
+    .priv_size     = sizeof(MultiScaleContext),
+    .priv_class    = &multiscale_class,
+    FILTER_INPUTS(ff_video_default_filterpad),
+    .outputs       = NULL,
+    FILTER_QUERY_FUNC(query_formats),
+    .flags         = AVFILTER_FLAG_DYNAMIC_OUTPUTS,
+};
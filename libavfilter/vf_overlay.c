@@ -32,7 +32,9 @@
 #include "libavutil/avstring.h"
 #include "libavutil/pixdesc.h"
 #include "libavutil/imgutils.h"
+#include "libavutil/intreadwrite.h"
 #include "libavutil/mathematics.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/timestamp.h"
 #include "internal.h"
@@ -85,6 +87,7 @@ static av_cold void uninit(AVFilterContext *ctx)
     OverlayContext *s = ctx->priv;
 
     ff_framesync_uninit(&s->fs);
+    av_freep(&s->tile_map);
     av_expr_free(s->x_pexpr); s->x_pexpr = NULL;
     av_expr_free(s->y_pexpr); s->y_pexpr = NULL;
 }
@@ -357,6 +360,34 @@ static int config_output(AVFilterLink *outlink)
 // ((((x) + (y)) << 8) - ((x) + (y)) - (y) * (x)) is a faster version of: 255 * (x + y)
 #define UNPREMULTIPLY_ALPHA(x, y) ((((x) << 16) - ((x) << 9) + (x)) / ((((x) + (y)) << 8) - ((x) + (y)) - (y) * (x)))
 
+/**
+ * Find the run of tiles of the same class that starts at sample start of a
+ * row of the tile map.
+ *
+ * @param tiles row of the tile map, NULL to blend the whole row
+ * @param sub   horizontal chroma subsampling of the plane
+ * @param type  set to the OverlayTileClass of the run
+ * @return end of the run, at most end
+ */
+static av_always_inline int tile_span(const uint8_t *tiles, int start, int end,
+                                      int sub, int *type)
+{
+    const int tile_w = OVERLAY_TILE >> sub;
+    int next;
+
+    if (!tiles) {
+        *type = OVERLAY_TILE_MIXED;
+        return end;
+    }
+    *type = tiles[start / tile_w];
+    next  = (start / tile_w + 1) * tile_w;
+    while (next < end && tiles[next / tile_w] == *type)
+        next += tile_w;
+    return FFMIN(next, end);
+}
+
+#define TILE_ROW(s, row) ((s)->tiles ? (s)->tiles + (row) / OVERLAY_TILE * (s)->tiles_stride : NULL)
+
 /**
  * Blend image in src to destination buffer dst at position (x, y).
  */
@@ -396,52 +427,60 @@ static av_always_inline void blend_slice_packed_rgb(AVFilterContext *ctx,
     dp = dst->data[0] + (y + slice_start) * dst->linesize[0];
 
     for (i = slice_start; i < slice_end; i++) {
-        j = FFMAX(-x, 0);
-        S = sp + j     * sstep;
-        d = dp + (x+j) * dstep;
-
-        for (jmax = FFMIN(-x + dst_w, src_w); j < jmax; j++) {
-            alpha = S[sa];
-
-            // if the main channel has an alpha channel, alpha has to be calculated
-            // to create an un-premultiplied (straight) alpha value
-            if (main_has_alpha && alpha != 0 && alpha != 255) {
-                uint8_t alpha_d = d[da];
-                alpha = UNPREMULTIPLY_ALPHA(alpha, alpha_d);
-            }
+        const uint8_t *tiles = TILE_ROW(s, i);
+        int jend, type;
+
+        jmax = FFMIN(-x + dst_w, src_w);
+        for (j = FFMAX(-x, 0); j < jmax; j = jend) {
+            jend = tile_span(tiles, j, jmax, 0, &type);
+            if (type == OVERLAY_TILE_TRANSPARENT)
+                continue;
+            S = sp + j     * sstep;
+            d = dp + (x+j) * dstep;
+
+            for (; j < jend; j++) {
+                alpha = S[sa];
+
+                // if the main channel has an alpha channel, alpha has to be calculated
+                // to create an un-premultiplied (straight) alpha value
+                if (main_has_alpha && alpha != 0 && alpha != 255) {
+                    uint8_t alpha_d = d[da];
+                    alpha = UNPREMULTIPLY_ALPHA(alpha, alpha_d);
+                }
 
-            switch (alpha) {
-            case 0:
-                break;
-            case 255:
-                d[dr] = S[sr];
-                d[dg] = S[sg];
-                d[db] = S[sb];
-                break;
-            default:
-                // main_value = main_value * (1 - alpha) + overlay_value * alpha
-                // since alpha is in the range 0-255, the result must divided by 255
-                d[dr] = is_straight ? FAST_DIV255(d[dr] * (255 - alpha) + S[sr] * alpha) :
-                        FFMIN(FAST_DIV255(d[dr] * (255 - alpha)) + S[sr], 255);
-                d[dg] = is_straight ? FAST_DIV255(d[dg] * (255 - alpha) + S[sg] * alpha) :
-                        FFMIN(FAST_DIV255(d[dg] * (255 - alpha)) + S[sg], 255);
-                d[db] = is_straight ? FAST_DIV255(d[db] * (255 - alpha) + S[sb] * alpha) :
-                        FFMIN(FAST_DIV255(d[db] * (255 - alpha)) + S[sb], 255);
-            }
-            if (main_has_alpha) {
                 switch (alpha) {
                 case 0:
                     break;
                 case 255:
-                    d[da] = S[sa];
+                    d[dr] = S[sr];
+                    d[dg] = S[sg];
+                    d[db] = S[sb];
                     break;
                 default:
-                    // apply alpha compositing: main_alpha += (1-main_alpha) * overlay_alpha
-                    d[da] += FAST_DIV255((255 - d[da]) * S[sa]);
+                    // main_value = main_value * (1 - alpha) + overlay_value * alpha
+                    // since alpha is in the range 0-255, the result must divided by 255
+                    d[dr] = is_straight ? FAST_DIV255(d[dr] * (255 - alpha) + S[sr] * alpha) :
+                            FFMIN(FAST_DIV255(d[dr] * (255 - alpha)) + S[sr], 255);
+                    d[dg] = is_straight ? FAST_DIV255(d[dg] * (255 - alpha) + S[sg] * alpha) :
+                            FFMIN(FAST_DIV255(d[dg] * (255 - alpha)) + S[sg], 255);
+                    d[db] = is_straight ? FAST_DIV255(d[db] * (255 - alpha) + S[sb] * alpha) :
+                            FFMIN(FAST_DIV255(d[db] * (255 - alpha)) + S[sb], 255);
+                }
+                if (main_has_alpha) {
+                    switch (alpha) {
+                    case 0:
+                        break;
+                    case 255:
+                        d[da] = S[sa];
+                        break;
+                    default:
+                        // apply alpha compositing: main_alpha += (1-main_alpha) * overlay_alpha
+                        d[da] += FAST_DIV255((255 - d[da]) * S[sa]);
+                    }
                 }
+                d += dstep;
+                S += sstep;
             }
-            d += dstep;
-            S += sstep;
         }
         dp += dst->linesize[0];
         sp += src->linesize[0];
@@ -477,6 +516,8 @@ static av_always_inline void blend_plane_##depth##_##nbits##bits(AVFilterContext
     const uint##depth##_t max = (1 << nbits) - 1;                                                          \
     const uint##depth##_t mid = (1 << (nbits -1)) ;                                                        \
     int bytes = depth / 8;                                                                                 \
+    const ptrdiff_t alinesize  = src->linesize[3] / bytes;                                                 \
+    const ptrdiff_t dalinesize = dst->linesize[3] / bytes;                                                 \
                                                                                                            \
     dst_step /= bytes;                                                                                     \
     j = FFMAX(-yp, 0);                                                                                     \
@@ -493,79 +534,98 @@ static av_always_inline void blend_plane_##depth##_##nbits##bits(AVFilterContext
     dap = (uint##depth##_t *)(dst->data[3] + ((yp + slice_start) << vsub) * dst->linesize[3]);             \
                                                                                                            \
     for (j = slice_start; j < slice_end; j++) {                                                            \
-        k = FFMAX(-xp, 0);                                                                                 \
-        d = dp + (xp+k) * dst_step;                                                                        \
-        s = sp + k;                                                                                        \
-        a = ap + (k<<hsub);                                                                                \
-        da = dap + ((xp+k) << hsub);                                                                       \
+        const uint8_t *tiles = TILE_ROW(octx, j << vsub);                                                  \
+        int kend, type;                                                                                    \
+                                                                                                           \
         kmax = FFMIN(-xp + dst_wp, src_wp);                                                                \
+        for (k = FFMAX(-xp, 0); k < kmax; k = kend) {                                                      \
+            kend = tile_span(tiles, k, kmax, hsub, &type);                                                 \
+            if (type == OVERLAY_TILE_TRANSPARENT)                                                          \
+                continue;                                                                                  \
+            d = dp + (xp+k) * dst_step;                                                                    \
+            s = sp + k;                                                                                    \
+            a = ap + (k<<hsub);                                                                            \
+            da = dap + ((xp+k) << hsub);                                                                   \
+                                                                                                           \
+            if (type == OVERLAY_TILE_OPAQUE) {                                                             \
+                if (dst_step == 1) {                                                                       \
+                    memcpy(d, s, (kend - k) * bytes);                                                      \
+                } else {                                                                                   \
+                    for (; k < kend; k++, d += dst_step)                                                   \
+                        *d = *s++;                                                                         \
+                }                                                                                          \
+                continue;                                                                                  \
+            }                                                                                              \
                                                                                                            \
-        if (nbits == 8 && ((vsub && j+1 < src_hp) || !vsub) && octx->blend_row[i]) {                       \
-            int c = octx->blend_row[i]((uint8_t*)d, (uint8_t*)da, (uint8_t*)s,                             \
-                    (uint8_t*)a, kmax - k, src->linesize[3]);                                              \
+            if (((vsub && j+1 < src_hp) || !vsub) && octx->blend_row[i]) {                                 \
+                int c = octx->blend_row[i]((uint8_t*)d, (uint8_t*)da, (uint8_t*)s,                         \
+                        (uint8_t*)a, kend - k, src->linesize[3]);                                          \
                                                                                                            \
-            s += c;                                                                                        \
-            d += dst_step * c;                                                                             \
-            da += (1 << hsub) * c;                                                                         \
-            a += (1 << hsub) * c;                                                                          \
-            k += c;                                                                                        \
-        }                                                                                                  \
-        for (; k < kmax; k++) {                                                                            \
-            int alpha_v, alpha_h, alpha;                                                                   \
+                s += c;                                                                                    \
+                d += dst_step * c;                                                                         \
+                da += (1 << hsub) * c;                                                                     \
+                a += (1 << hsub) * c;                                                                      \
+                k += c;                                                                                    \
+            }                                                                                              \
+            for (; k < kend; k++) {                                                                        \
+                int alpha_v, alpha_h, alpha;                                                               \
                                                                                                            \
-            /* average alpha for color components, improve quality */                                      \
-            if (hsub && vsub && j+1 < src_hp && k+1 < src_wp) {                                            \
-                alpha = (a[0] + a[src->linesize[3]] +                                                      \
-                         a[1] + a[src->linesize[3]+1]) >> 2;                                               \
-            } else if (hsub || vsub) {                                                                     \
-                alpha_h = hsub && k+1 < src_wp ?                                                           \
-                    (a[0] + a[1]) >> 1 : a[0];                                                             \
-                alpha_v = vsub && j+1 < src_hp ?                                                           \
-                    (a[0] + a[src->linesize[3]]) >> 1 : a[0];                                              \
-                alpha = (alpha_v + alpha_h) >> 1;                                                          \
-            } else                                                                                         \
-                alpha = a[0];                                                                              \
-            /* if the main channel has an alpha channel, alpha has to be calculated */                     \
-            /* to create an un-premultiplied (straight) alpha value */                                     \
-            if (main_has_alpha && alpha != 0 && alpha != max) {                                            \
                 /* average alpha for color components, improve quality */                                  \
-                uint8_t alpha_d;                                                                           \
                 if (hsub && vsub && j+1 < src_hp && k+1 < src_wp) {                                        \
-                    alpha_d = (da[0] + da[dst->linesize[3]] +                                              \
-                               da[1] + da[dst->linesize[3]+1]) >> 2;                                       \
+                    alpha = (a[0] + a[alinesize] +                                                         \
+                             a[1] + a[alinesize+1]) >> 2;                                                  \
                 } else if (hsub || vsub) {                                                                 \
                     alpha_h = hsub && k+1 < src_wp ?                                                       \
-                        (da[0] + da[1]) >> 1 : da[0];                                                      \
+                        (a[0] + a[1]) >> 1 : a[0];                                                         \
                     alpha_v = vsub && j+1 < src_hp ?                                                       \
-                        (da[0] + da[dst->linesize[3]]) >> 1 : da[0];                                       \
-                    alpha_d = (alpha_v + alpha_h) >> 1;                                                    \
+                        (a[0] + a[alinesize]) >> 1 : a[0];                                                 \
+                    alpha = (alpha_v + alpha_h) >> 1;                                                      \
                 } else                                                                                     \
-                    alpha_d = da[0];                                                                       \
-                alpha = UNPREMULTIPLY_ALPHA(alpha, alpha_d);                                               \
-            }                                                                                              \
-            if (straight) {                                                                                \
-                if (nbits > 8)                                                                             \
-                   *d = (*d * (max - alpha) + *s * alpha) / max;                                           \
-                else                                                                                       \
-                    *d = FAST_DIV255(*d * (255 - alpha) + *s * alpha);                                     \
-            } else {                                                                                       \
-                if (nbits > 8) {                                                                           \
-                    if (i && yuv)                                                                          \
-                        *d = av_clip((*d * (max - alpha) + *s * alpha) / max + *s - mid, -mid, mid) + mid; \
+                    alpha = a[0];                                                                          \
+                /* if the main channel has an alpha channel, alpha has to be calculated */                 \
+                /* to create an un-premultiplied (straight) alpha value */                                 \
+                if (main_has_alpha && alpha != 0 && alpha != max) {                                        \
+                    /* average alpha for color components, improve quality */                              \
+                    uint8_t alpha_d;                                                                       \
+                    if (hsub && vsub && j+1 < src_hp && k+1 < src_wp) {                                    \
+                        alpha_d = (da[0] + da[dalinesize] +                                                \
+                                   da[1] + da[dalinesize+1]) >> 2;                                         \
+                    } else if (hsub || vsub) {                                                             \
+                        alpha_h = hsub && k+1 < src_wp ?                                                   \
+                            (da[0] + da[1]) >> 1 : da[0];                                                  \
+                        alpha_v = vsub && j+1 < src_hp ?                                                   \
+                            (da[0] + da[dalinesize]) >> 1 : da[0];                                         \
+                        alpha_d = (alpha_v + alpha_h) >> 1;                                                \
+                    } else                                                                                 \
+                        alpha_d = da[0];                                                                   \
+                    alpha = UNPREMULTIPLY_ALPHA(alpha, alpha_d);                                           \
+                }                                                                                          \
+                if (straight) {                                                                            \
+                    if (nbits > 8)                                                                         \
+                       *d = (*d * (max - alpha) + *s * alpha) / max;                                       \
                     else                                                                                   \
-                        *d = av_clip_uintp2((*d * (max - alpha) + *s * alpha) / max + *s - (16<<(nbits-8)),\
-                                                                                                    nbits);\
+                        *d = FAST_DIV255(*d * (255 - alpha) + *s * alpha);                                 \
                 } else {                                                                                   \
-                    if (i && yuv)                                                                          \
-                        *d = av_clip(FAST_DIV255((*d - mid) * (max - alpha)) + *s - mid, -mid, mid) + mid; \
-                    else                                                                                   \
-                        *d = av_clip_uint8(FAST_DIV255(*d * (255 - alpha)) + *s - 16);                     \
+                    if (nbits > 8) {                                                                       \
+                        if (i && yuv)                                                                      \
+                            *d = av_clip((*d * (max - alpha) + *s * alpha) / max + *s - mid,               \
+                                         -mid, mid) + mid;                                                 \
+                        else                                                                               \
+                            *d = av_clip_uintp2((*d * (max - alpha) + *s * alpha) / max +                  \
+                                                *s - (16<<(nbits-8)), nbits);                              \
+                    } else {                                                                               \
+                        if (i && yuv)                                                                      \
+                            *d = av_clip(FAST_DIV255((*d - mid) * (max - alpha)) + *s - mid,               \
+                                         -mid, mid) + mid;                                                 \
+                        else                                                                               \
+                            *d = av_clip_uint8(FAST_DIV255(*d * (255 - alpha)) + *s - 16);                 \
+                    }                                                                                      \
                 }                                                                                          \
+                s++;                                                                                       \
+                d += dst_step;                                                                             \
+                da += 1 << hsub;                                                                           \
+                a += 1 << hsub;                                                                            \
             }                                                                                              \
-            s++;                                                                                           \
-            d += dst_step;                                                                                 \
-            da += 1 << hsub;                                                                               \
-            a += 1 << hsub;                                                                                \
         }                                                                                                  \
         dp += dst->linesize[dst_plane] / bytes;                                                            \
         sp += src->linesize[i] / bytes;                                                                    \
@@ -577,7 +637,8 @@ DEFINE_BLEND_PLANE(8, 8)
 DEFINE_BLEND_PLANE(16, 10)
 
 #define DEFINE_ALPHA_COMPOSITE(depth, nbits)                                                               \
-static inline void alpha_composite_##depth##_##nbits##bits(const AVFrame *src, const AVFrame *dst,         \
+static inline void alpha_composite_##depth##_##nbits##bits(const OverlayContext *octx,                     \
+                                   const AVFrame *src, const AVFrame *dst,                                 \
                                    int src_w, int src_h,                                                   \
                                    int dst_w, int dst_h,                                                   \
                                    int x, int y,                                                           \
@@ -600,27 +661,40 @@ static inline void alpha_composite_##depth##_##nbits##bits(const AVFrame *src, c
     da = (uint##depth##_t *)(dst->data[3] + (y + slice_start) * dst->linesize[3]);                         \
                                                                                                            \
     for (i = slice_start; i < slice_end; i++) {                                                            \
-        j = FFMAX(-x, 0);                                                                                  \
-        s = sa + j;                                                                                        \
-        d = da + x+j;                                                                                      \
+        const uint8_t *tiles = TILE_ROW(octx, i);                                                          \
+        int jend, type;                                                                                    \
+                                                                                                           \
+        jmax = FFMIN(-x + dst_w, src_w);                                                                   \
+        for (j = FFMAX(-x, 0); j < jmax; j = jend) {                                                       \
+            jend = tile_span(tiles, j, jmax, 0, &type);                                                    \
+            if (type == OVERLAY_TILE_TRANSPARENT)                                                          \
+                continue;                                                                                  \
+            s = sa + j;                                                                                    \
+            d = da + x+j;                                                                                  \
                                                                                                            \
-        for (jmax = FFMIN(-x + dst_w, src_w); j < jmax; j++) {                                             \
-            alpha = *s;                                                                                    \
-            if (alpha != 0 && alpha != max) {                                                              \
-                uint8_t alpha_d = *d;                                                                      \
-                alpha = UNPREMULTIPLY_ALPHA(alpha, alpha_d);                                               \
+            if (type == OVERLAY_TILE_OPAQUE) {                                                             \
+                memcpy(d, s, (jend - j) * bytes);                                                          \
+                continue;                                                                                  \
             }                                                                                              \
-            if (alpha == max)                                                                              \
-                *d = *s;                                                                                   \
-            else if (alpha > 0) {                                                                          \
-                /* apply alpha compositing: main_alpha += (1-main_alpha) * overlay_alpha */                \
-                if (nbits > 8)                                                                             \
-                    *d += (max - *d) * *s / max;                                                           \
-                else                                                                                       \
-                    *d += FAST_DIV255((max - *d) * *s);                                                    \
+                                                                                                           \
+            for (; j < jend; j++) {                                                                        \
+                alpha = *s;                                                                                \
+                if (alpha != 0 && alpha != max) {                                                          \
+                    uint8_t alpha_d = *d;                                                                  \
+                    alpha = UNPREMULTIPLY_ALPHA(alpha, alpha_d);                                           \
+                }                                                                                          \
+                if (alpha == max)                                                                          \
+                    *d = *s;                                                                               \
+                else if (alpha > 0) {                                                                      \
+                    /* apply alpha compositing: main_alpha += (1-main_alpha) * overlay_alpha */            \
+                    if (nbits > 8)                                                                         \
+                        *d += (max - *d) * *s / max;                                                       \
+                    else                                                                                   \
+                        *d += FAST_DIV255((max - *d) * *s);                                                \
+                }                                                                                          \
+                d += 1;                                                                                    \
+                s += 1;                                                                                    \
             }                                                                                              \
-            d += 1;                                                                                        \
-            s += 1;                                                                                        \
         }                                                                                                  \
         da += dst->linesize[3] / bytes;                                                                    \
         sa += src->linesize[3] / bytes;                                                                    \
@@ -655,7 +729,7 @@ static av_always_inline void blend_slice_yuv_##depth##_##nbits##bits(AVFilterCon
                 s->main_desc->comp[2].step, is_straight, 1, jobnr, nb_jobs);                               \
                                                                                                            \
     if (main_has_alpha)                                                                                    \
-        alpha_composite_##depth##_##nbits##bits(src, dst, src_w, src_h, dst_w, dst_h, x, y,                \
+        alpha_composite_##depth##_##nbits##bits(s, src, dst, src_w, src_h, dst_w, dst_h, x, y,             \
                                                 jobnr, nb_jobs);                                           \
 }
 DEFINE_BLEND_SLICE_YUV(8, 8)
@@ -687,7 +761,7 @@ static av_always_inline void blend_slice_planar_rgb(AVFilterContext *ctx,
                 jobnr, nb_jobs);
 
     if (main_has_alpha)
-        alpha_composite_8_8bits(src, dst, src_w, src_h, dst_w, dst_h, x, y, jobnr, nb_jobs);
+        alpha_composite_8_8bits(s, src, dst, src_w, src_h, dst_w, dst_h, x, y, jobnr, nb_jobs);
 }
 
 #define DEFINE_BLEND_SLICE_PLANAR_FMT(format_, blend_slice_fn_suffix_, hsub_, vsub_, main_has_alpha_, direct_) \
@@ -875,6 +949,68 @@ end:
     return 0;
 }
 
+/**
+ * Classify each tile of the overlay picture by its alpha, so that blending
+ * can skip the transparent tiles and copy the opaque ones. The map is reused
+ * as long as the same overlay picture is blended.
+ */
+static int update_tiles(OverlayContext *s, const AVFrame *src, int64_t pts)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(src->format);
+    const AVComponentDescriptor *comp = &desc->comp[3];
+    const uint8_t *alpha = src->data[comp->plane] + comp->offset;
+    const ptrdiff_t linesize = src->linesize[comp->plane];
+    const unsigned max = (1 << comp->depth) - 1;
+    const int tiles_w = (src->width  + OVERLAY_TILE - 1) / OVERLAY_TILE;
+    const int tiles_h = (src->height + OVERLAY_TILE - 1) / OVERLAY_TILE;
+
+    s->tiles = s->tile_map;
+    if (pts != AV_NOPTS_VALUE && pts == s->tiles_pts && alpha == s->tiles_alpha &&
+        src->width == s->tiles_width && src->height == s->tiles_height)
+        return 0;
+
+    av_fast_malloc(&s->tile_map, &s->tile_map_size, tiles_w * tiles_h);
+    s->tiles = s->tile_map;
+    if (!s->tile_map)
+        return AVERROR(ENOMEM);
+
+    for (int ty = 0; ty < tiles_h; ty++) {
+        const int h = FFMIN(OVERLAY_TILE, src->height - ty * OVERLAY_TILE);
+
+        for (int tx = 0; tx < tiles_w; tx++) {
+            const int w = FFMIN(OVERLAY_TILE, src->width - tx * OVERLAY_TILE);
+            const uint8_t *row = alpha + ty * OVERLAY_TILE * linesize +
+                                 tx * OVERLAY_TILE * comp->step;
+            unsigned all = max, any = 0;
+
+            for (int y = 0; y < h && (!any || all == max); y++) {
+                if (comp->depth > 8) {
+                    for (int x = 0; x < w; x++) {
+                        all &= AV_RN16(row + x * comp->step);
+                        any |= AV_RN16(row + x * comp->step);
+                    }
+                } else {
+                    for (int x = 0; x < w; x++) {
+                        all &= row[x * comp->step];
+                        any |= row[x * comp->step];
+                    }
+                }
+                row += linesize;
+            }
+            s->tile_map[ty * tiles_w + tx] = !any        ? OVERLAY_TILE_TRANSPARENT :
+                                             all == max ? OVERLAY_TILE_OPAQUE      :
+                                                          OVERLAY_TILE_MIXED;
+        }
+    }
+
+    s->tiles_stride = tiles_w;
+    s->tiles_alpha  = alpha;
+    s->tiles_width  = src->width;
+    s->tiles_height = src->height;
+    s->tiles_pts    = pts;
+    return 0;
+}
+
 static int do_blend(FFFrameSync *fs)
 {
     AVFilterContext *ctx = fs->parent;
@@ -919,6 +1055,16 @@ FF_ENABLE_DEPRECATION_WARNINGS
         s->y < mainpic->height && s->y + second->height >= 0) {
         ThreadData td;
 
+        /* skipping and copying tiles is only exact for straight alpha */
+        s->tiles = NULL;
+        if (!s->alpha_format) {
+            ret = update_tiles(s, second, second->pts);
+            if (ret < 0) {
+                av_frame_free(&mainpic);
+                return ret;
+            }
+        }
+
         td.dst = mainpic;
         td.src = second;
         ff_filter_execute(ctx, s->blend_slice, &td, NULL, FFMIN(FFMAX(1, FFMIN3(s->y + second->height, FFMIN(second->height, mainpic->height), mainpic->height - s->y)),
@@ -932,6 +1078,7 @@ static av_cold int init(AVFilterContext *ctx)
     OverlayContext *s = ctx->priv;
 
     s->fs.on_event = do_blend;
+    s->tiles_pts   = AV_NOPTS_VALUE;
     return 0;
 }
 
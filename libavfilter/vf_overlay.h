@@ -41,6 +41,15 @@ enum var_name {
     VAR_VARS_NB
 };
 
+/** Size in luma samples of the square tiles used to skip the alpha blending */
+#define OVERLAY_TILE 32
+
+enum OverlayTileClass {
+    OVERLAY_TILE_TRANSPARENT,
+    OVERLAY_TILE_OPAQUE,
+    OVERLAY_TILE_MIXED,
+};
+
 enum OverlayFormat {
     OVERLAY_FORMAT_YUV420,
     OVERLAY_FORMAT_YUV420P10,
@@ -80,6 +89,14 @@ typedef struct OverlayContext {
 
     AVExpr *x_pexpr, *y_pexpr;
 
+    uint8_t *tile_map;          ///< OVERLAY_TILE_* class of each tile of the overlay
+    unsigned int tile_map_size;
+    const uint8_t *tiles;       ///< tile_map if it applies to the current blend, else NULL
+    int tiles_stride;
+    const uint8_t *tiles_alpha; ///< overlay alpha data the tile map was computed for
+    int tiles_width, tiles_height;
+    int64_t tiles_pts;
+
     int (*blend_row[4])(uint8_t *d, uint8_t *da, uint8_t *s, uint8_t *a, int w,
                         ptrdiff_t alinesize);
     int (*blend_slice)(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs);
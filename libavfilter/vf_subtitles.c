@@ -37,9 +37,16 @@
 # include "libavformat/avformat.h"
 #endif
 #include "libavutil/avstring.h"
+#include "libavutil/crc.h"
+#include "libavutil/file_open.h"
 #include "libavutil/imgutils.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/md5.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/parseutils.h"
+#include "libavutil/random_seed.h"
+#include "libavutil/time.h"
 #include "drawutils.h"
 #include "avfilter.h"
 #include "internal.h"
@@ -48,6 +55,29 @@
 
 #define FF_ASS_FEATURE_WRAP_UNICODE     (LIBASS_VERSION >= 0x01600010)
 
+#if LIBASS_VERSION < 0x01300000
+/* Before libass 0.13, the font provider argument only toggled fontconfig */
+#define ASS_FONTPROVIDER_NONE       0
+#define ASS_FONTPROVIDER_AUTODETECT 1
+#define ASS_FONTPROVIDER_FONTCONFIG 1
+#endif
+
+#define CACHE_TAG         MKTAG('A', 'S', 'S', 'R')
+#define CACHE_HEADER_SIZE 24
+#define CACHE_IMAGE_SIZE  20
+
+/**
+ * Record of the render cache file: images which did not change over a time
+ * range. A record is made of a header (tag, start, end, payload size), the
+ * payload (number of images, then for each image its size, position, color
+ * and bitmap) and a CRC of all that.
+ */
+typedef struct CachedRange {
+    int64_t start, end;         ///< time range in ms
+    int64_t offset;             ///< position of the record in the file
+    uint32_t size;              ///< size of the payload
+} CachedRange;
+
 typedef struct AssContext {
     const AVClass *class;
     ASS_Library  *library;
@@ -55,6 +85,11 @@ typedef struct AssContext {
     ASS_Track    *track;
     char *filename;
     char *fontsdir;
+    char *default_font;
+    char *default_family;
+    char *fontconfig_file;
+    int fontprovider;
+    int fontconfig_update;
     char *charenc;
     char *force_style;
     int stream_index;
@@ -65,6 +100,36 @@ typedef struct AssContext {
     int shaping;
     FFDrawContext draw;
     int wrap_unicode;
+
+    char *cache_dir;
+    int64_t cache_max_size;
+    char *cache_path;           ///< cache file
+    char *cache_tmp_path;       ///< private file the new records are written to
+    FILE *cache_in, *cache_out;
+    int cache_out_records;      ///< number of records in cache_out
+    int64_t cache_out_size;     ///< size of the records in cache_out
+    CachedRange *written;       ///< ranges of the records in cache_out
+    unsigned written_size;
+    int nb_written;
+    uint8_t fonts_digest[16];   ///< MD5 of the attached fonts
+    CachedRange *ranges;        ///< ranges of cache_in, sorted and disjoint
+    int nb_ranges;
+    unsigned ranges_size;
+    int cur_range;              ///< range whose images are in cached_images
+    ASS_Image *cached_images;
+    unsigned cached_images_size;
+    int nb_cached_images;
+    uint8_t *cache_buf;
+    unsigned cache_buf_size;
+    uint8_t *record;            ///< record of the range being rendered
+    unsigned record_size;
+    size_t record_len;
+    int record_open;
+    int64_t record_start, record_end;
+    int64_t *boundaries;        ///< sorted start and end times of the events
+    int nb_boundaries;
+    uint64_t cache_hits, cache_misses;
+    int ranges_written;
 } AssContext;
 
 #define OFFSET(x) offsetof(AssContext, x)
@@ -76,6 +141,16 @@ typedef struct AssContext {
     {"original_size",  "set the size of the original video (used to scale fonts)", OFFSET(original_w), AV_OPT_TYPE_IMAGE_SIZE, {.str = NULL},  0, 0, FLAGS }, \
     {"fontsdir",       "set the directory containing the fonts to read",           OFFSET(fontsdir),   AV_OPT_TYPE_STRING,     {.str = NULL},  0, 0, FLAGS }, \
     {"alpha",          "enable processing of alpha channel",                       OFFSET(alpha),      AV_OPT_TYPE_BOOL,       {.i64 = 0   },         0,        1, FLAGS }, \
+    {"fontprovider",   "set the system font provider",                             OFFSET(fontprovider), AV_OPT_TYPE_INT,      {.i64 = ASS_FONTPROVIDER_AUTODETECT}, 0, INT_MAX, FLAGS, .unit = "fontprovider" }, \
+        {"none",       "only use embedded fonts, fontsdir and default_font",       0, AV_OPT_TYPE_CONST, {.i64 = ASS_FONTPROVIDER_NONE},       INT_MIN, INT_MAX, FLAGS, .unit = "fontprovider" }, \
+        {"auto",       "use the platform default font provider",                   0, AV_OPT_TYPE_CONST, {.i64 = ASS_FONTPROVIDER_AUTODETECT}, INT_MIN, INT_MAX, FLAGS, .unit = "fontprovider" }, \
+        {"fontconfig", "use fontconfig",                                           0, AV_OPT_TYPE_CONST, {.i64 = ASS_FONTPROVIDER_FONTCONFIG}, INT_MIN, INT_MAX, FLAGS, .unit = "fontprovider" }, \
+    {"fontconfig_file",   "set the fontconfig configuration file",                 OFFSET(fontconfig_file),   AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, FLAGS }, \
+    {"fontconfig_update", "update the fontconfig cache",                           OFFSET(fontconfig_update), AV_OPT_TYPE_BOOL,   {.i64 = 1   }, 0, 1, FLAGS }, \
+    {"default_font",   "set the path of the fallback font",                        OFFSET(default_font),   AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, FLAGS }, \
+    {"default_family", "set the family of the fallback font",                      OFFSET(default_family), AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, FLAGS }, \
+    {"cache_dir",      "set the directory of the render cache",                    OFFSET(cache_dir),      AV_OPT_TYPE_STRING, {.str = NULL}, 0, 0, FLAGS }, \
+    {"cache_max_size", "set the maximum size of a render cache file",              OFFSET(cache_max_size), AV_OPT_TYPE_INT64,  {.i64 = 256 << 20}, 0, INT64_MAX, FLAGS }, \
 
 /* libass supports a log level ranging from 0 to 7 */
 static const int ass_libavfilter_log_level_map[] = {
@@ -127,10 +202,621 @@ static av_cold int init(AVFilterContext *ctx)
     return 0;
 }
 
+static av_cold void set_fonts(AVFilterContext *ctx)
+{
+    AssContext *ass = ctx->priv;
+    int64_t start = av_gettime_relative();
+
+    ass_set_fonts(ass->renderer, ass->default_font, ass->default_family,
+                  ass->fontprovider, ass->fontconfig_file,
+                  ass->fontconfig_update);
+
+    av_log(ctx, AV_LOG_DEBUG, "Font setup took %"PRId64" us\n",
+           av_gettime_relative() - start);
+}
+
+static void hash_str(struct AVMD5 *md5, const char *str)
+{
+    if (!str)
+        str = "";
+    av_md5_update(md5, (const uint8_t *)str, strlen(str) + 1);
+}
+
+#define HASH(v) av_md5_update(md5, (const uint8_t *)&(v), sizeof(v))
+
+#if CONFIG_SUBTITLES_FILTER
+static int cmp_dir_entry(const void *a, const void *b)
+{
+    const AVIODirEntry *e1 = *(const AVIODirEntry * const *)a;
+    const AVIODirEntry *e2 = *(const AVIODirEntry * const *)b;
+    return strcmp(e1->name, e2->name);
+}
+#endif
+
+/**
+ * Hash the name, size and modification time of the entries of fontsdir, so
+ * that adding or replacing a font there changes the cache key.
+ */
+static int hash_fonts_dir(AssContext *ass, struct AVMD5 *md5)
+{
+#if CONFIG_SUBTITLES_FILTER
+    AVIODirContext *dir = NULL;
+    AVIODirEntry *entry, **entries = NULL;
+    unsigned entries_size = 0;
+    int nb_entries = 0;
+    int ret;
+
+    ret = avio_open_dir(&dir, ass->fontsdir, NULL);
+    if (ret < 0)
+        return ret;
+    while ((ret = avio_read_dir(dir, &entry)) >= 0 && entry) {
+        AVIODirEntry **tmp = av_fast_realloc(entries, &entries_size,
+                                             (nb_entries + 1) * sizeof(*entries));
+        if (!tmp) {
+            avio_free_directory_entry(&entry);
+            ret = AVERROR(ENOMEM);
+            break;
+        }
+        entries = tmp;
+        entries[nb_entries++] = entry;
+    }
+    avio_close_dir(&dir);
+
+    if (ret >= 0) {
+        /* the listing order is not defined */
+        qsort(entries, nb_entries, sizeof(*entries), cmp_dir_entry);
+        for (int i = 0; i < nb_entries; i++) {
+            hash_str(md5, entries[i]->name);
+            HASH(entries[i]->size);
+            HASH(entries[i]->modification_timestamp);
+        }
+    }
+
+    for (int i = 0; i < nb_entries; i++)
+        avio_free_directory_entry(&entries[i]);
+    av_free(entries);
+    return ret;
+#else
+    return AVERROR(ENOSYS);
+#endif
+}
+
+/**
+ * Compute the name of the cache file from the script and everything else
+ * the rendering depends on.
+ *
+ * @return AVERROR(ENOSYS) if fontsdir cannot be listed
+ */
+static int cache_key(AVFilterContext *ctx, AVFilterLink *inlink, char *key)
+{
+    AssContext *ass = ctx->priv;
+    const ASS_Track *track = ass->track;
+    const int version = LIBASS_VERSION;
+    uint8_t digest[16];
+    struct AVMD5 *md5 = av_md5_alloc();
+
+    if (!md5)
+        return AVERROR(ENOMEM);
+    av_md5_init(md5);
+
+    HASH(version);
+    HASH(inlink->w);
+    HASH(inlink->h);
+    HASH(ass->original_w);
+    HASH(ass->original_h);
+    HASH(ass->shaping);
+    HASH(ass->wrap_unicode);
+    HASH(ass->fontprovider);
+    HASH(ass->fonts_digest);
+    hash_str(md5, ass->fontsdir);
+    if (ass->fontsdir) {
+        int ret = hash_fonts_dir(ass, md5);
+        if (ret < 0) {
+            av_free(md5);
+            return ret == AVERROR(ENOMEM) ? ret : AVERROR(ENOSYS);
+        }
+    }
+    hash_str(md5, ass->fontconfig_file);
+    hash_str(md5, ass->default_font);
+    hash_str(md5, ass->default_family);
+    hash_str(md5, ass->force_style);
+
+    HASH(track->PlayResX);
+    HASH(track->PlayResY);
+    HASH(track->WrapStyle);
+    HASH(track->ScaledBorderAndShadow);
+    HASH(track->Kerning);
+    for (int i = 0; i < track->n_styles; i++) {
+        const ASS_Style *st = &track->styles[i];
+        hash_str(md5, st->Name);
+        hash_str(md5, st->FontName);
+        HASH(st->FontSize);
+        HASH(st->PrimaryColour);
+        HASH(st->SecondaryColour);
+        HASH(st->OutlineColour);
+        HASH(st->BackColour);
+        HASH(st->Bold);
+        HASH(st->Italic);
+        HASH(st->Underline);
+        HASH(st->StrikeOut);
+        HASH(st->ScaleX);
+        HASH(st->ScaleY);
+        HASH(st->Spacing);
+        HASH(st->Angle);
+        HASH(st->BorderStyle);
+        HASH(st->Outline);
+        HASH(st->Shadow);
+        HASH(st->Alignment);
+        HASH(st->MarginL);
+        HASH(st->MarginR);
+        HASH(st->MarginV);
+        HASH(st->Encoding);
+    }
+    for (int i = 0; i < track->n_events; i++) {
+        const ASS_Event *ev = &track->events[i];
+        HASH(ev->Start);
+        HASH(ev->Duration);
+        HASH(ev->Layer);
+        HASH(ev->Style);
+        HASH(ev->MarginL);
+        HASH(ev->MarginR);
+        HASH(ev->MarginV);
+        hash_str(md5, ev->Effect);
+        hash_str(md5, ev->Text);
+    }
+
+    av_md5_final(md5, digest);
+    av_free(md5);
+    for (int i = 0; i < 16; i++)
+        snprintf(key + 2 * i, 3, "%02x", digest[i]);
+    return 0;
+}
+
+static int cmp_range(const void *a, const void *b)
+{
+    const CachedRange *r1 = a, *r2 = b;
+    return FFDIFFSIGN(r1->start, r2->start);
+}
+
+static int cmp_int64(const void *a, const void *b)
+{
+    return FFDIFFSIGN(*(const int64_t *)a, *(const int64_t *)b);
+}
+
+/**
+ * Read the rest of the record whose header is hdr and check its CRC.
+ *
+ * @return 0 if the record is valid, AVERROR_INVALIDDATA if it is not
+ */
+static int cache_check_record(AssContext *ass, FILE *f, const uint8_t *hdr)
+{
+    const uint32_t size = AV_RL32(hdr + 20);
+    uint8_t *buf;
+
+    if (AV_RL32(hdr) != CACHE_TAG || size > INT_MAX - CACHE_HEADER_SIZE - 4 ||
+        (int64_t)AV_RL64(hdr + 4) > (int64_t)AV_RL64(hdr + 12))
+        return AVERROR_INVALIDDATA;
+
+    buf = av_fast_realloc(ass->cache_buf, &ass->cache_buf_size,
+                          CACHE_HEADER_SIZE + size + 4);
+    if (!buf)
+        return AVERROR(ENOMEM);
+    ass->cache_buf = buf;
+    memcpy(buf, hdr, CACHE_HEADER_SIZE);
+    if (fread(buf + CACHE_HEADER_SIZE, 1, size + 4, f) != size + 4 ||
+        AV_RL32(buf + CACHE_HEADER_SIZE + size) !=
+        av_crc(av_crc_get_table(AV_CRC_32_IEEE_LE), 0, buf, CACHE_HEADER_SIZE + size))
+        return AVERROR_INVALIDDATA;
+    return 0;
+}
+
+/**
+ * Find the next record tag after a damaged record starting at offset.
+ *
+ * @return the position of the tag, or a negative value if there is none
+ */
+static int64_t cache_resync(FILE *f, int64_t offset)
+{
+    uint32_t state = 0;
+    int c;
+
+    if (fseek(f, ++offset, SEEK_SET))
+        return -1;
+    while ((c = getc(f)) != EOF) {
+        offset++;
+        state = state >> 8 | (uint32_t)c << 24;
+        if (state == CACHE_TAG) {
+            offset -= 4;
+            return fseek(f, offset, SEEK_SET) ? -1 : offset;
+        }
+    }
+    return -1;
+}
+
+/* Check the records, and keep a disjoint set of ranges of the valid ones. */
+static int cache_load_ranges(AssContext *ass)
+{
+    uint8_t hdr[CACHE_HEADER_SIZE];
+    int64_t offset = 0;
+    int nb_ranges = 0;
+
+    while (fread(hdr, 1, sizeof(hdr), ass->cache_in) == sizeof(hdr)) {
+        CachedRange *ranges, *r;
+        int ret = cache_check_record(ass, ass->cache_in, hdr);
+
+        if (ret == AVERROR(ENOMEM))
+            return ret;
+        if (ret < 0) {
+            offset = cache_resync(ass->cache_in, offset);
+            if (offset < 0)
+                break;
+            continue;
+        }
+
+        ranges = av_fast_realloc(ass->ranges, &ass->ranges_size,
+                                 (ass->nb_ranges + 1) * sizeof(*ass->ranges));
+        if (!ranges)
+            return AVERROR(ENOMEM);
+        ass->ranges = ranges;
+        r = &ranges[ass->nb_ranges++];
+        r->start  = AV_RL64(hdr + 4);
+        r->end    = AV_RL64(hdr + 12);
+        r->size   = AV_RL32(hdr + 20);
+        r->offset = offset;
+        offset += CACHE_HEADER_SIZE + r->size + 4;
+    }
+
+    qsort(ass->ranges, ass->nb_ranges, sizeof(*ass->ranges), cmp_range);
+    for (int i = 0; i < ass->nb_ranges; i++)
+        if (!nb_ranges || ass->ranges[i].start > ass->ranges[nb_ranges - 1].end)
+            ass->ranges[nb_ranges++] = ass->ranges[i];
+    ass->nb_ranges = nb_ranges;
+    return 0;
+}
+
+static int cache_find_range(const AssContext *ass, int64_t t)
+{
+    int lo = 0, hi = ass->nb_ranges - 1;
+
+    while (lo <= hi) {
+        const int mid = (lo + hi) >> 1;
+        if (ass->ranges[mid].start > t)
+            hi = mid - 1;
+        else if (ass->ranges[mid].end < t)
+            lo = mid + 1;
+        else
+            return mid;
+    }
+    return -1;
+}
+
+static int cache_read_images(AssContext *ass, int idx)
+{
+    const CachedRange *r = &ass->ranges[idx];
+    const size_t size = CACHE_HEADER_SIZE + r->size + 4;
+    const uint8_t *p, *end;
+    ASS_Image *images;
+    unsigned nb_images;
+    uint8_t *buf;
+
+    ass->cur_range = -1;
+    buf = av_fast_realloc(ass->cache_buf, &ass->cache_buf_size, size);
+    if (!buf)
+        return AVERROR(ENOMEM);
+    ass->cache_buf = buf;
+    if (fseek(ass->cache_in, r->offset, SEEK_SET) ||
+        fread(buf, 1, size, ass->cache_in) != size ||
+        AV_RL32(buf + size - 4) != av_crc(av_crc_get_table(AV_CRC_32_IEEE_LE), 0, buf, size - 4) ||
+        r->size < 4)
+        return AVERROR_INVALIDDATA;
+
+    p   = buf + CACHE_HEADER_SIZE;
+    end = p + r->size;
+    nb_images = AV_RL32(p);
+    p += 4;
+    if (nb_images > (end - p) / CACHE_IMAGE_SIZE)
+        return AVERROR_INVALIDDATA;
+    images = av_fast_realloc(ass->cached_images, &ass->cached_images_size,
+                             FFMAX(nb_images, 1) * sizeof(*images));
+    if (!images)
+        return AVERROR(ENOMEM);
+    ass->cached_images = images;
+
+    for (unsigned i = 0; i < nb_images; i++) {
+        ASS_Image *img = &images[i];
+
+        if (end - p < CACHE_IMAGE_SIZE)
+            return AVERROR_INVALIDDATA;
+        img->w      = AV_RL32(p);
+        img->h      = AV_RL32(p +  4);
+        img->dst_x  = AV_RL32(p +  8);
+        img->dst_y  = AV_RL32(p + 12);
+        img->color  = AV_RL32(p + 16);
+        img->stride = img->w;
+        img->bitmap = (uint8_t *)p + CACHE_IMAGE_SIZE;
+        img->next   = i + 1 < nb_images ? &images[i + 1] : NULL;
+        p += CACHE_IMAGE_SIZE;
+        if (img->w < 0 || img->h < 0 || (int64_t)img->w * img->h > end - p)
+            return AVERROR_INVALIDDATA;
+        p += img->w * img->h;
+    }
+
+    ass->nb_cached_images = nb_images;
+    ass->cur_range = idx;
+    return 0;
+}
+
+/* Start a new record with the images rendered at time t. */
+static int cache_record_images(AssContext *ass, const ASS_Image *image, int64_t t)
+{
+    size_t size = CACHE_HEADER_SIZE + 4 + 4;
+    unsigned nb_images = 0;
+    uint8_t *p;
+
+    ass->record_open = 0;
+    for (const ASS_Image *img = image; img; img = img->next) {
+        size += CACHE_IMAGE_SIZE + (size_t)img->w * img->h;
+        nb_images++;
+    }
+    if (size > INT_MAX)
+        return 0;
+
+    p = av_fast_realloc(ass->record, &ass->record_size, size);
+    if (!p)
+        return AVERROR(ENOMEM);
+    ass->record = p;
+
+    p += CACHE_HEADER_SIZE;
+    AV_WL32(p, nb_images);
+    p += 4;
+    for (const ASS_Image *img = image; img; img = img->next) {
+        AV_WL32(p,      img->w);
+        AV_WL32(p +  4, img->h);
+        AV_WL32(p +  8, img->dst_x);
+        AV_WL32(p + 12, img->dst_y);
+        AV_WL32(p + 16, img->color);
+        p += CACHE_IMAGE_SIZE;
+        for (int y = 0; y < img->h; y++, p += img->w)
+            memcpy(p, img->bitmap + y * img->stride, img->w);
+    }
+
+    ass->record_len   = size;
+    ass->record_start = ass->record_end = t;
+    ass->record_open  = 1;
+    return 0;
+}
+
+static void cache_flush(AVFilterContext *ctx)
+{
+    AssContext *ass = ctx->priv;
+    uint8_t *rec = ass->record;
+    const size_t len = ass->record_len;
+    CachedRange *written;
+
+    if (!ass->record_open)
+        return;
+    ass->record_open = 0;
+
+    AV_WL32(rec,      CACHE_TAG);
+    AV_WL64(rec +  4, ass->record_start);
+    AV_WL64(rec + 12, ass->record_end);
+    AV_WL32(rec + 20, len - CACHE_HEADER_SIZE - 4);
+    AV_WL32(rec + len - 4, av_crc(av_crc_get_table(AV_CRC_32_IEEE_LE), 0, rec, len - 4));
+
+    if (fwrite(rec, 1, len, ass->cache_out) != len) {
+        av_log(ctx, AV_LOG_WARNING, "Error writing to the render cache\n");
+        fclose(ass->cache_out);
+        ass->cache_out = NULL;
+        remove(ass->cache_tmp_path);
+        return;
+    }
+    /* a missing range only keeps a redundant record in cache_commit() */
+    written = av_fast_realloc(ass->written, &ass->written_size,
+                              (ass->nb_written + 1) * sizeof(*ass->written));
+    if (written) {
+        ass->written = written;
+        written[ass->nb_written].start = ass->record_start;
+        written[ass->nb_written].end   = ass->record_end;
+        ass->nb_written++;
+    }
+    ass->cache_out_records++;
+    ass->cache_out_size += len;
+    ass->ranges_written++;
+}
+
+/**
+ * Check whether [start, end] lies within a range written by this instance.
+ * ass->written must be sorted by start, with each end replaced by the
+ * maximum end of the ranges up to it.
+ */
+static int cache_written_covers(const AssContext *ass, int64_t start, int64_t end)
+{
+    int lo = 0, hi = ass->nb_written;
+
+    while (lo < hi) {
+        const int mid = (lo + hi) >> 1;
+        if (ass->written[mid].start <= start)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo && ass->written[lo - 1].end >= end;
+}
+
+/**
+ * Publish the new records: append the records of the cache file to them and
+ * rename the result over the cache file. Other instances thus only ever see
+ * complete files; records written concurrently by another instance may be
+ * lost, but not mixed up.
+ *
+ * Records of the cache file which are damaged or covered by a new record are
+ * dropped. The file is kept below cache_max_size by dropping the records at
+ * its end, which are the oldest ones; the new records are always kept.
+ */
+static void cache_commit(AVFilterContext *ctx)
+{
+    AssContext *ass = ctx->priv;
+    int64_t size = ass->cache_out_size;
+    int err = 0;
+
+    if (ass->cache_out_records) {
+        FILE *in = avpriv_fopen_utf8(ass->cache_path, "rb");
+        uint8_t hdr[CACHE_HEADER_SIZE];
+        int64_t offset = 0;
+
+        if (ass->nb_written)
+            qsort(ass->written, ass->nb_written, sizeof(*ass->written), cmp_range);
+        for (int i = 1; i < ass->nb_written; i++)
+            ass->written[i].end = FFMAX(ass->written[i].end, ass->written[i - 1].end);
+
+        while (in && fread(hdr, 1, sizeof(hdr), in) == sizeof(hdr)) {
+            const size_t len = CACHE_HEADER_SIZE + AV_RL32(hdr + 20) + 4;
+            int ret = cache_check_record(ass, in, hdr);
+
+            if (ret == AVERROR(ENOMEM))
+                break;
+            if (ret < 0) {
+                offset = cache_resync(in, offset);
+                if (offset < 0)
+                    break;
+                continue;
+            }
+            offset += len;
+
+            if (cache_written_covers(ass, AV_RL64(hdr + 4), AV_RL64(hdr + 12)))
+                continue;
+            if (ass->cache_max_size && size + len > ass->cache_max_size)
+                break;
+            if (fwrite(ass->cache_buf, 1, len, ass->cache_out) != len) {
+                err = 1;
+                break;
+            }
+            size += len;
+        }
+        if (in)
+            fclose(in);
+    }
+    if (fclose(ass->cache_out))
+        err = 1;
+    ass->cache_out = NULL;
+
+    if (!err && ass->cache_out_records &&
+        rename(ass->cache_tmp_path, ass->cache_path)) {
+        /* rename() does not replace an existing file everywhere */
+        remove(ass->cache_path);
+        err = rename(ass->cache_tmp_path, ass->cache_path);
+    }
+    if (err)
+        av_log(ctx, AV_LOG_WARNING, "Error writing the render cache '%s'\n",
+               ass->cache_path);
+    if (err || !ass->cache_out_records)
+        remove(ass->cache_tmp_path);
+}
+
+static void cache_close(AVFilterContext *ctx)
+{
+    AssContext *ass = ctx->priv;
+
+    if (ass->cache_in) {
+        fclose(ass->cache_in);
+        ass->cache_in = NULL;
+    }
+    if (ass->cache_out) {
+        cache_flush(ctx);
+        if (ass->cache_out)
+            cache_commit(ctx);
+    }
+    av_freep(&ass->cache_path);
+    av_freep(&ass->cache_tmp_path);
+    ass->cache_out_records = 0;
+    ass->cache_out_size = 0;
+    av_freep(&ass->written);
+    ass->written_size = ass->nb_written = 0;
+    av_freep(&ass->ranges);
+    av_freep(&ass->cached_images);
+    av_freep(&ass->cache_buf);
+    av_freep(&ass->record);
+    av_freep(&ass->boundaries);
+    ass->nb_ranges = ass->nb_boundaries = 0;
+    ass->ranges_size = ass->cached_images_size = 0;
+    ass->cache_buf_size = ass->record_size = 0;
+    ass->cur_range = -1;
+}
+
+static int cache_open(AVFilterContext *ctx, AVFilterLink *inlink)
+{
+    AssContext *ass = ctx->priv;
+    char key[33];
+    int ret;
+
+    cache_close(ctx);
+
+    ass->boundaries = av_malloc_array(FFMAX(2 * ass->track->n_events, 1),
+                                      sizeof(*ass->boundaries));
+    if (!ass->boundaries)
+        return AVERROR(ENOMEM);
+    for (int i = 0; i < ass->track->n_events; i++) {
+        const ASS_Event *ev = &ass->track->events[i];
+        ass->boundaries[ass->nb_boundaries++] = ev->Start;
+        ass->boundaries[ass->nb_boundaries++] = ev->Start + ev->Duration;
+    }
+    qsort(ass->boundaries, ass->nb_boundaries, sizeof(*ass->boundaries), cmp_int64);
+
+    ret = cache_key(ctx, inlink, key);
+    if (ret == AVERROR(ENOSYS)) {
+        av_log(ctx, AV_LOG_WARNING, "Cannot list the fonts directory, "
+               "render cache disabled\n");
+        return 0;
+    }
+    if (ret < 0)
+        return ret;
+    ass->cache_path     = av_asprintf("%s/%s.asscache", ass->cache_dir, key);
+    ass->cache_tmp_path = av_asprintf("%s/%s.%08"PRIx32".tmp", ass->cache_dir, key,
+                                      av_get_random_seed());
+    if (!ass->cache_path || !ass->cache_tmp_path)
+        return AVERROR(ENOMEM);
+
+    ass->cache_in = avpriv_fopen_utf8(ass->cache_path, "rb");
+    if (ass->cache_in) {
+        ret = cache_load_ranges(ass);
+        if (ret < 0)
+            return ret;
+    }
+    /* new records go to a file of this instance, see cache_commit() */
+    ass->cache_out = avpriv_fopen_utf8(ass->cache_tmp_path, "wb");
+    if (!ass->cache_out)
+        av_log(ctx, AV_LOG_WARNING, "Cannot write to the render cache '%s'\n",
+               ass->cache_tmp_path);
+    av_log(ctx, AV_LOG_VERBOSE, "Render cache '%s' with %d ranges\n",
+           ass->cache_path, ass->nb_ranges);
+    return 0;
+}
+
+/* Check whether an event starts or ends in (a, b]. */
+static int event_boundary_between(const AssContext *ass, int64_t a, int64_t b)
+{
+    int lo = 0, hi = ass->nb_boundaries;
+
+    while (lo < hi) {
+        const int mid = (lo + hi) >> 1;
+        if (ass->boundaries[mid] <= a)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < ass->nb_boundaries && ass->boundaries[lo] <= b;
+}
+
 static av_cold void uninit(AVFilterContext *ctx)
 {
     AssContext *ass = ctx->priv;
 
+    cache_close(ctx);
+    if (ass->cache_dir)
+        av_log(ctx, AV_LOG_INFO, "Render cache: %"PRIu64" hits, %"PRIu64" misses, "
+               "%d ranges written\n", ass->cache_hits, ass->cache_misses,
+               ass->ranges_written);
+
     if (ass->track)
         ass_free_track(ass->track);
     if (ass->renderer)
@@ -162,6 +848,9 @@ static int config_input(AVFilterLink *inlink)
     if (ass->shaping != -1)
         ass_set_shaper(ass->renderer, ass->shaping);
 
+    if (ass->cache_dir)
+        return cache_open(inlink->dst, inlink);
+
     return 0;
 }
 
@@ -186,18 +875,62 @@ static void overlay_ass_image(AssContext *ass, AVFrame *picref,
     }
 }
 
+/**
+ * Render the frame at time_ms, or take it from the render cache. Renders
+ * which do not change and during which no event starts or ends are merged
+ * into one range of the cache.
+ */
+static int render_frame(AVFilterContext *ctx, double time_ms, ASS_Image **image)
+{
+    AssContext *ass = ctx->priv;
+    const int64_t t = time_ms;
+    int detect_change = 0;
+    int idx = cache_find_range(ass, t);
+
+    if (idx >= 0 && (idx == ass->cur_range || cache_read_images(ass, idx) >= 0)) {
+        cache_flush(ctx);
+        ass->cache_hits++;
+        *image = ass->nb_cached_images ? ass->cached_images : NULL;
+        return 0;
+    }
+    if (idx >= 0) {
+        av_log(ctx, AV_LOG_WARNING, "Invalid render cache record at %"PRId64"\n",
+               ass->ranges[idx].offset);
+        memmove(&ass->ranges[idx], &ass->ranges[idx + 1],
+                (ass->nb_ranges - idx - 1) * sizeof(*ass->ranges));
+        ass->nb_ranges--;
+    }
+
+    *image = ass_render_frame(ass->renderer, ass->track, t, &detect_change);
+    if (detect_change)
+        av_log(ctx, AV_LOG_DEBUG, "Change happened at time ms:%f\n", time_ms);
+
+    ass->cache_misses++;
+    if (!ass->cache_out)
+        return 0;
+    if (ass->record_open && !detect_change && t >= ass->record_end &&
+        !event_boundary_between(ass, ass->record_end, t)) {
+        ass->record_end = t;
+        return 0;
+    }
+    cache_flush(ctx);
+    return cache_record_images(ass, *image, t);
+}
+
 static int filter_frame(AVFilterLink *inlink, AVFrame *picref)
 {
     AVFilterContext *ctx = inlink->dst;
     AVFilterLink *outlink = ctx->outputs[0];
     AssContext *ass = ctx->priv;
-    int detect_change = 0;
     double time_ms = picref->pts * av_q2d(inlink->time_base) * 1000;
-    ASS_Image *image = ass_render_frame(ass->renderer, ass->track,
-                                        time_ms, &detect_change);
+    ASS_Image *image;
+    int ret;
 
-    if (detect_change)
-        av_log(ctx, AV_LOG_DEBUG, "Change happened at time ms:%f\n", time_ms);
+    ret = render_frame(ctx, time_ms, &image);
+    if (ret < 0) {
+        av_frame_free(&picref);
+        return ret;
+    }
 
     overlay_ass_image(ass, picref, image);
 
@@ -236,7 +969,7 @@ static av_cold int init_ass(AVFilterContext *ctx)
         return ret;
 
     /* Initialize fonts */
-    ass_set_fonts(ass->renderer, NULL, NULL, 1, NULL, 1);
+    set_fonts(ctx);
 
     ass->track = ass_read_file(ass->library, ass->filename, NULL);
     if (!ass->track) {
@@ -318,6 +1051,7 @@ static av_cold int init_subtitles(AVFilterContext *ctx)
     const AVCodecDescriptor *dec_desc;
     AVStream *st;
     AVPacket pkt;
+    struct AVMD5 *md5 = NULL;
     AssContext *ass = ctx->priv;
 
     /* Init libass */
@@ -367,6 +1101,14 @@ static av_cold int init_subtitles(AVFilterContext *ctx)
     st = fmt->streams[sid];
 
     /* Load attached fonts */
+    if (ass->cache_dir) {
+        md5 = av_md5_alloc();
+        if (!md5) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        av_md5_init(md5);
+    }
     for (j = 0; j < fmt->nb_streams; j++) {
         AVStream *st = fmt->streams[j];
         if (st->codecpar->codec_type == AVMEDIA_TYPE_ATTACHMENT &&
@@ -381,15 +1123,25 @@ static av_cold int init_subtitles(AVFilterContext *ctx)
                 ass_add_font(ass->library, tag->value,
                              st->codecpar->extradata,
                              st->codecpar->extradata_size);
+                if (md5) {
+                    hash_str(md5, tag->value);
+                    HASH(st->codecpar->extradata_size);
+                    av_md5_update(md5, st->codecpar->extradata,
+                                  st->codecpar->extradata_size);
+                }
             } else {
                 av_log(ctx, AV_LOG_WARNING,
                        "Font attachment has no filename, ignored.\n");
             }
         }
     }
+    if (md5) {
+        av_md5_final(md5, ass->fonts_digest);
+        av_freep(&md5);
+    }
 
     /* Initialize fonts */
-    ass_set_fonts(ass->renderer, NULL, NULL, 1, NULL, 1);
+    set_fonts(ctx);
 
     /* Open decoder */
     dec = avcodec_find_decoder(st->codecpar->codec_id);
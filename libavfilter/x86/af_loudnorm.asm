@@ -0,0 +1,253 @@
+;*****************************************************************************
+;* x86-optimized functions for loudnorm filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+ps_abs_mask: times 8 dd 0x7fffffff
+pd_abs_mask: times 4 dq 0x7fffffffffffffff
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; void ff_loudnorm_kweight(float *dst, const float *src, float *state,
+;                          const float *coeffs, ptrdiff_t channels,
+;                          ptrdiff_t len)
+;------------------------------------------------------------------------------
+
+%macro KWEIGHT 0
+cglobal loudnorm_kweight, 6, 11, 8, dst, src, state, coeffs, stride, len, groups, n, in, out, stride3
+    mov         groupsq, strideq
+    shr         groupsq, mmsize / 16 + 1
+    shl         strideq, 2
+    lea        stride3q, [strideq*3]
+.group:
+    mova             m0, [stateq]
+    mova             m1, [stateq + strideq]
+    mova             m2, [stateq + strideq*2]
+    mova             m3, [stateq + stride3q]
+    mov             inq, srcq
+    mov            outq, dstq
+    mov              nq, lenq
+.loop:
+    mova             m4, [inq]                   ; x
+%if cpuflag(fma3)
+    fmaddps          m0, m4, [coeffsq + 0*32], m0 ; y = b0 * x + s0
+    fmaddps          m2, m0, [coeffsq + 5*32], m2 ; z = c0 * y + s2
+    fmaddps          m1, m4, [coeffsq + 1*32], m1
+    fnmaddps         m1, m0, [coeffsq + 3*32], m1 ; s0 = b1 * x - a1 * y + s1
+    mulps            m5, m4, [coeffsq + 2*32]
+    fnmaddps         m5, m0, [coeffsq + 4*32], m5 ; s1 = b2 * x - a2 * y
+    fmaddps          m3, m0, [coeffsq + 6*32], m3
+    fnmaddps         m3, m2, [coeffsq + 8*32], m3 ; s2 = c1 * y - d1 * z + s3
+    mulps            m6, m0, [coeffsq + 7*32]
+    fnmaddps         m6, m2, [coeffsq + 9*32], m6 ; s3 = c2 * y - d2 * z
+
+    mova         [outq], m2
+    mova             m0, m1
+    mova             m1, m5
+    mova             m2, m3
+    mova             m3, m6
+%else
+    mulps            m5, m4, [coeffsq + 0*32]
+    addps            m5, m0                      ; y = b0 * x + s0
+    mulps            m6, m5, [coeffsq + 5*32]
+    addps            m6, m2                      ; z = c0 * y + s2
+
+    mulps            m0, m4, [coeffsq + 1*32]
+    mulps            m7, m5, [coeffsq + 3*32]
+    subps            m0, m7
+    addps            m0, m1                      ; s0 = b1 * x - a1 * y + s1
+    mulps            m1, m4, [coeffsq + 2*32]
+    mulps            m7, m5, [coeffsq + 4*32]
+    subps            m1, m7                      ; s1 = b2 * x - a2 * y
+
+    mulps            m2, m5, [coeffsq + 6*32]
+    mulps            m7, m6, [coeffsq + 8*32]
+    subps            m2, m7
+    addps            m2, m3                      ; s2 = c1 * y - d1 * z + s3
+    mulps            m3, m5, [coeffsq + 7*32]
+    mulps            m7, m6, [coeffsq + 9*32]
+    subps            m3, m7                      ; s3 = c2 * y - d2 * z
+
+    mova         [outq], m6
+%endif
+    add             inq, strideq
+    add            outq, strideq
+    dec              nq
+    jg .loop
+
+    mova        [stateq], m0
+    mova        [stateq + strideq], m1
+    mova        [stateq + strideq*2], m2
+    mova        [stateq + stride3q], m3
+    add            srcq, mmsize
+    add            dstq, mmsize
+    add          stateq, mmsize
+    dec         groupsq
+    jg .group
+    RET
+%endmacro
+
+%if ARCH_X86_64
+INIT_XMM sse
+KWEIGHT
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+KWEIGHT
+%endif
+%if HAVE_FMA3_EXTERNAL
+INIT_YMM fma3
+KWEIGHT
+%endif
+%endif
+
+;------------------------------------------------------------------------------
+; void ff_loudnorm_energy(double *sum, const float *src, ptrdiff_t channels,
+;                         ptrdiff_t len)
+;------------------------------------------------------------------------------
+
+%macro ENERGY 0
+cglobal loudnorm_energy, 4, 7, 4, sum, src, stride, len, c, n, in
+    shl         strideq, 2
+    xor              cq, cq
+.group:
+    xorpd            m0, m0
+    xorpd            m1, m1
+    lea             inq, [srcq + cq]
+    mov              nq, lenq
+.loop:
+    cvtps2pd         m2, [inq]
+    cvtps2pd         m3, [inq + mmsize / 2]
+    mulpd            m2, m2
+    mulpd            m3, m3
+    addpd            m0, m2
+    addpd            m1, m3
+    add             inq, strideq
+    dec              nq
+    jg .loop
+
+    movu             m2, [sumq + cq*2]
+    movu             m3, [sumq + cq*2 + mmsize]
+    addpd            m0, m2
+    addpd            m1, m3
+    movu  [sumq + cq*2], m0
+    movu  [sumq + cq*2 + mmsize], m1
+    add              cq, mmsize
+    cmp              cq, strideq
+    jl .group
+    RET
+%endmacro
+
+INIT_XMM sse2
+ENERGY
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+ENERGY
+%endif
+
+;------------------------------------------------------------------------------
+; void ff_loudnorm_peak(float *peak, const float *src, ptrdiff_t channels,
+;                       ptrdiff_t len)
+;------------------------------------------------------------------------------
+
+%macro PEAK 0
+cglobal loudnorm_peak, 4, 7, 3, peak, src, stride, len, c, n, in
+    shl         strideq, 2
+    xor              cq, cq
+    mova             m2, [ps_abs_mask]
+.group:
+    movu             m0, [peakq + cq]
+    lea             inq, [srcq + cq]
+    mov              nq, lenq
+.loop:
+    andps            m1, m2, [inq]
+    maxps            m0, m1
+    add             inq, strideq
+    dec              nq
+    jg .loop
+
+    movu   [peakq + cq], m0
+    add              cq, mmsize
+    cmp              cq, strideq
+    jl .group
+    RET
+%endmacro
+
+INIT_XMM sse
+PEAK
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+PEAK
+%endif
+
+;------------------------------------------------------------------------------
+; double ff_loudnorm_max_abs(const double *src, ptrdiff_t len)
+;------------------------------------------------------------------------------
+
+%macro MAX_ABS 0
+cglobal loudnorm_max_abs, 2, 2, 3, src, len
+    mova             m2, [pd_abs_mask]
+    xorpd            m0, m0
+    shl            lenq, 3
+    add            srcq, lenq
+    neg            lenq
+    cmp            lenq, -mmsize
+    jg .tail
+.loop:
+    movu             m1, [srcq + lenq]
+    andpd            m1, m2
+    maxpd            m0, m1
+    add            lenq, mmsize
+    cmp            lenq, -mmsize
+    jle .loop
+.tail:
+%if mmsize == 32
+    vextractf128    xm1, m0, 1
+    maxpd           xm0, xm1
+    cmp            lenq, -16
+    jg .tail1
+    andpd           xm1, xm2, [srcq + lenq]
+    maxpd           xm0, xm1
+    add            lenq, 16
+.tail1:
+%endif
+    test           lenq, lenq
+    jz .end
+    movsd           xm1, [srcq + lenq]
+    andpd           xm1, xm2
+    maxpd           xm0, xm1
+.end:
+    movhlps         xm1, xm0
+    maxsd           xm0, xm1
+%if ARCH_X86_64 == 0
+    movsd          r0m, xm0
+    fld    qword   r0m
+%endif
+    RET
+%endmacro
+
+INIT_XMM sse2
+MAX_ABS
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+MAX_ABS
+%endif
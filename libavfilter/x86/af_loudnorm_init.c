@@ -0,0 +1,74 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/af_loudnormdsp.h"
+
+void ff_loudnorm_kweight_sse(float *dst, const float *src, float *state,
+                             const float *coeffs, ptrdiff_t channels,
+                             ptrdiff_t len);
+void ff_loudnorm_energy_sse2(double *sum, const float *src,
+                             ptrdiff_t channels, ptrdiff_t len);
+void ff_loudnorm_peak_sse(float *peak, const float *src,
+                          ptrdiff_t channels, ptrdiff_t len);
+double ff_loudnorm_max_abs_sse2(const double *src, ptrdiff_t len);
+
+void ff_loudnorm_kweight_avx(float *dst, const float *src, float *state,
+                             const float *coeffs, ptrdiff_t channels,
+                             ptrdiff_t len);
+void ff_loudnorm_kweight_fma3(float *dst, const float *src, float *state,
+                              const float *coeffs, ptrdiff_t channels,
+                              ptrdiff_t len);
+void ff_loudnorm_energy_avx(double *sum, const float *src,
+                            ptrdiff_t channels, ptrdiff_t len);
+void ff_loudnorm_peak_avx(float *peak, const float *src,
+                          ptrdiff_t channels, ptrdiff_t len);
+double ff_loudnorm_max_abs_avx(const double *src, ptrdiff_t len);
+
+av_cold void ff_loudnorm_init_x86(LoudNormDSPContext *dsp)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE(cpu_flags)) {
+#if ARCH_X86_64
+        dsp->kweight = ff_loudnorm_kweight_sse;
+#endif
+        dsp->peak    = ff_loudnorm_peak_sse;
+    }
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        dsp->energy  = ff_loudnorm_energy_sse2;
+        dsp->max_abs = ff_loudnorm_max_abs_sse2;
+    }
+    /* the 8 lane versions need the channels padded to 8 */
+    if (EXTERNAL_AVX_FAST(cpu_flags)) {
+#if ARCH_X86_64
+        dsp->kweight = ff_loudnorm_kweight_avx;
+#endif
+        dsp->energy  = ff_loudnorm_energy_avx;
+        dsp->peak    = ff_loudnorm_peak_avx;
+        dsp->max_abs = ff_loudnorm_max_abs_avx;
+        dsp->channel_align = 8;
+    }
+#if ARCH_X86_64
+    if (EXTERNAL_FMA3_FAST(cpu_flags))
+        dsp->kweight = ff_loudnorm_kweight_fma3;
+#endif
+}
@@ -0,0 +1,87 @@
+;*****************************************************************************
+;* x86-optimized true-peak oversampling
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+
+%include "libavutil/x86/x86util.asm"
+
+%define TAPS 12
+
+SECTION_RODATA 32
+
+pd_abs_mask: times 4 dq 0x7fffffffffffffff
+
+SECTION .text
+
+;------------------------------------------------------------------------------
+; double ff_truepeak_upsample_max(const double *src, const double *coeffs,
+;                                 ptrdiff_t len)
+;------------------------------------------------------------------------------
+
+%macro UPSAMPLE_MAX 0
+cglobal truepeak_upsample_max, 3, 3, 6, src, coeffs, len
+    movu             m5, [pd_abs_mask]
+    xorpd            m4, m4
+    shl            lenq, 3
+    add            srcq, lenq
+    neg            lenq
+.loop:
+    xorpd            m0, m0
+    xorpd            m1, m1
+%assign k 0
+%rep TAPS
+    movu             m2, [srcq + lenq + k*8]
+%if cpuflag(fma3)
+    vfmadd231pd      m0, m2, [coeffsq + k*32]
+    vfmadd231pd      m1, m2, [coeffsq + (TAPS + k)*32]
+%else
+    mulpd            m3, m2, [coeffsq + k*32]
+    mulpd            m2, [coeffsq + (TAPS + k)*32]
+    addpd            m0, m3
+    addpd            m1, m2
+%endif
+%assign k k+1
+%endrep
+    andpd            m0, m5
+    andpd            m1, m5
+    maxpd            m4, m0
+    maxpd            m4, m1
+    add            lenq, mmsize
+    jl .loop
+
+%if mmsize == 32
+    vextractf128    xm0, m4, 1
+    maxpd           xm4, xm0
+%endif
+    movhlps         xm0, xm4
+    maxsd           xm0, xm4
+%if ARCH_X86_64 == 0
+    movsd          r0m, xm0
+    fld    qword   r0m
+%endif
+    RET
+%endmacro
+
+INIT_XMM sse2
+UPSAMPLE_MAX
+
+%if HAVE_FMA3_EXTERNAL
+INIT_YMM fma3
+UPSAMPLE_MAX
+%endif
@@ -0,0 +1,40 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/truepeak.h"
+
+double ff_truepeak_upsample_max_sse2(const double *src, const double *coeffs,
+                                     ptrdiff_t len);
+double ff_truepeak_upsample_max_fma3(const double *src, const double *coeffs,
+                                     ptrdiff_t len);
+
+av_cold void ff_truepeak_dsp_init_x86(TruePeakDSPContext *dsp)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        dsp->upsample_max = ff_truepeak_upsample_max_sse2;
+    }
+    if (EXTERNAL_FMA3_FAST(cpu_flags)) {
+        dsp->upsample_max = ff_truepeak_upsample_max_fma3;
+    }
+}
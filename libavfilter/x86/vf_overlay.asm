@@ -23,52 +23,41 @@
 
 %include "libavutil/x86/x86util.asm"
 
-SECTION_RODATA
+SECTION_RODATA 32
 
-pb_1:     times 16 db 1
-pw_128:   times  8 dw 128
-pw_255:   times  8 dw 255
-pw_257:   times  8 dw 257
+pb_1:     times 32 db 1
+pw_1:     times 16 dw 1
+pw_3_1:   times  8 dw 3, 1
+pw_16:    times 16 dw 16
+pw_128:   times 16 dw 128
+pw_255:   times 16 dw 255
+pw_256:   times 16 dw 256
+pw_257:   times 16 dw 257
+pw_1023:  times 16 dw 1023
+pw_ff00:  times 16 dw 0xff00
+pd_1:     times  8 dd 1
 
 SECTION .text
 
-INIT_XMM sse4
-cglobal overlay_row_44, 5, 7, 6, 0, dst, da, s, a, w, r, x
-    xor          xq, xq
-    movsxdifnidn wq, wd
-    mov          rq, wq
-    and          rq, mmsize/2 - 1
-    cmp          wq, mmsize/2
-    jl .end
-    sub          wq, rq
-    mova         m3, [pw_255]
-    mova         m4, [pw_128]
-    mova         m5, [pw_257]
-    .loop:
-        pmovzxbw    m0, [sq+xq]
-        pmovzxbw    m2, [aq+xq]
-        pmovzxbw    m1, [dstq+xq]
-        pmullw      m0, m2
-        pxor        m2, m3
-        pmullw      m1, m2
-        paddw       m0, m4
-        paddw       m0, m1
-        pmulhuw     m0, m5
-        packuswb    m0, m0
-        movq [dstq+xq], m0
-        add         xq, mmsize/2
-        cmp         xq, wq
-        jl .loop
-
-    .end:
-    mov    eax, xd
-    RET
+%define STRAIGHT 0
+%define PREMULT  1 ; premultiplied overlay, luma or RGB
+%define PREMULTC 2 ; premultiplied overlay, chroma
 
-INIT_XMM sse4
-cglobal overlay_row_22, 5, 7, 6, 0, dst, da, s, a, w, r, x
+; Blend up to w samples of one 8-bit plane and return how many were done.
+; %1 = function name suffix, %2 = alpha subsampling (44, 22 or 20),
+; %3 = blend mode, %4 = 1 if the destination samples are interleaved
+; with the other chroma plane (NV12/NV21)
+%macro OVERLAY_ROW 3-4 0
+cglobal overlay_row_%1, 6, 7, 8, 0, dst, da, s, a, w, r, x
+%if %2 == 20
+    mov         daq, aq
+    add         daq, rmp
+%endif
     xor          xq, xq
     movsxdifnidn wq, wd
+%if %2 != 44
     sub          wq, 1
+%endif
     mov          rq, wq
     and          rq, mmsize/2 - 1
     cmp          wq, mmsize/2
@@ -77,23 +66,74 @@ cglobal overlay_row_22, 5, 7, 6, 0, dst, da, s, a, w, r, x
     mova         m3, [pw_255]
     mova         m4, [pw_128]
     mova         m5, [pw_257]
+%if %2 == 20
+    mova         m6, [pb_1]
+%endif
     .loop:
-        pmovzxbw    m0, [sq+xq]
+%if %2 == 44
+        pmovzxbw    m2, [aq+xq]
+%elif %2 == 22
         movu        m1, [aq+2*xq]
         pandn       m2, m3, m1
         psllw       m1, 8
         pavgw       m2, m1
         pavgw       m2, m1
         psrlw       m2, 8
+%else
+        movu        m2, [aq+2*xq]
+        movu        m1, [daq+2*xq]
+        pmaddubsw   m2, m6
+        pmaddubsw   m1, m6
+        paddw       m2, m1
+        psrlw       m2, 2
+%endif
+        pmovzxbw    m0, [sq+xq]
+%if %4
+        movu        m1, [dstq+2*xq]
+        pand        m1, m3
+%else
         pmovzxbw    m1, [dstq+xq]
+%endif
+%if %3 == STRAIGHT
         pmullw      m0, m2
         pxor        m2, m3
         pmullw      m1, m2
         paddw       m0, m4
         paddw       m0, m1
         pmulhuw     m0, m5
+%elif %3 == PREMULT
+        pxor        m2, m3
+        pmullw      m1, m2
+        paddw       m1, m4
+        pmulhuw     m1, m5
+        paddw       m0, m1
+        psubw       m0, [pw_16]
+%else
+        psubw       m1, m4
+        pxor        m2, m3
+        pmullw      m1, m2
+        paddw       m1, m4
+        pmulhw      m1, m5
+        paddw       m0, m1
+        pxor        m7, m7
+        pmaxsw      m0, m7
+        pminsw      m0, [pw_256]
+        pand        m0, m3
+%endif
+%if %4
+        movu        m7, [dstq+2*xq]
+        pand        m7, [pw_ff00]
+        por         m0, m7
+        movu [dstq+2*xq], m0
+%else
         packuswb    m0, m0
+%if mmsize == 32
+        vpermq      m0, m0, q3120
+        movu [dstq+xq], xm0
+%else
         movq [dstq+xq], m0
+%endif
+%endif
         add         xq, mmsize/2
         cmp         xq, wq
         jl .loop
@@ -101,40 +141,72 @@ cglobal overlay_row_22, 5, 7, 6, 0, dst, da, s, a, w, r, x
     .end:
     mov    eax, xd
     RET
+%endmacro
 
-INIT_XMM sse4
-cglobal overlay_row_20, 6, 7, 7, 0, dst, da, s, a, w, r, x
+; Same for 10-bit planes, straight alpha only.
+; %1 = alpha subsampling (44, 22 or 20)
+%macro OVERLAY_ROW_10 1
+cglobal overlay_row_%1_10, 6, 7, 8, 0, dst, da, s, a, w, r, x
+%if %1 == 20
     mov         daq, aq
     add         daq, rmp
+%endif
     xor          xq, xq
     movsxdifnidn wq, wd
+%if %1 != 44
     sub          wq, 1
+%endif
     mov          rq, wq
     and          rq, mmsize/2 - 1
     cmp          wq, mmsize/2
     jl .end
     sub          wq, rq
-    mova         m3, [pw_255]
-    mova         m4, [pw_128]
-    mova         m5, [pw_257]
-    mova         m6, [pb_1]
+    mova         m7, [pw_1023]
+    mova         m6, [pd_1]
     .loop:
-        pmovzxbw    m0, [sq+xq]
+%if %1 == 44
         movu        m2, [aq+2*xq]
-        movu        m1, [daq+2*xq]
-        pmaddubsw   m2, m6
-        pmaddubsw   m1, m6
-        paddw       m2, m1
-        psrlw       m2, 2
-        pmovzxbw    m1, [dstq+xq]
-        pmullw      m0, m2
-        pxor        m2, m3
-        pmullw      m1, m2
-        paddw       m0, m4
-        paddw       m0, m1
-        pmulhuw     m0, m5
-        packuswb    m0, m0
-        movq [dstq+xq], m0
+%else
+        movu        m2, [aq+4*xq]
+        movu        m1, [aq+4*xq+mmsize]
+%if %1 == 22
+        pmaddwd     m2, [pw_3_1]
+        pmaddwd     m1, [pw_3_1]
+%else
+        movu        m3, [daq+4*xq]
+        movu        m4, [daq+4*xq+mmsize]
+        paddw       m2, m3
+        paddw       m1, m4
+        pmaddwd     m2, [pw_1]
+        pmaddwd     m1, [pw_1]
+%endif
+        psrld       m2, 2
+        psrld       m1, 2
+        packssdw    m2, m1
+%if mmsize == 32
+        vpermq      m2, m2, q3120
+%endif
+%endif
+        movu        m0, [sq+2*xq]
+        movu        m1, [dstq+2*xq]
+        psubw       m3, m7, m2
+        punpckhwd   m4, m1, m0
+        punpcklwd   m1, m0
+        punpckhwd   m5, m3, m2
+        punpcklwd   m3, m2
+        pmaddwd     m1, m3
+        pmaddwd     m4, m5
+        ; x / 1023 == (x + (x >> 10) + 1) >> 10 for x <= 1023 * 1023
+        psrld       m3, m1, 10
+        psrld       m5, m4, 10
+        paddd       m1, m6
+        paddd       m4, m6
+        paddd       m1, m3
+        paddd       m4, m5
+        psrld       m1, 10
+        psrld       m4, 10
+        packusdw    m1, m4
+        movu [dstq+2*xq], m1
         add         xq, mmsize/2
         cmp         xq, wq
         jl .loop
@@ -142,3 +214,27 @@ cglobal overlay_row_20, 6, 7, 7, 0, dst, da, s, a, w, r, x
     .end:
     mov    eax, xd
     RET
+%endmacro
+
+%macro OVERLAY_ROW_FUNCS 0
+OVERLAY_ROW 44,        44, STRAIGHT
+OVERLAY_ROW 22,        22, STRAIGHT
+OVERLAY_ROW 20,        20, STRAIGHT
+OVERLAY_ROW 20_nv,     20, STRAIGHT, 1
+OVERLAY_ROW 44_pm,     44, PREMULT
+OVERLAY_ROW 44_pmc,    44, PREMULTC
+OVERLAY_ROW 22_pmc,    22, PREMULTC
+OVERLAY_ROW 20_pmc,    20, PREMULTC
+OVERLAY_ROW 20_pmc_nv, 20, PREMULTC, 1
+OVERLAY_ROW_10 44
+OVERLAY_ROW_10 22
+OVERLAY_ROW_10 20
+%endmacro
+
+INIT_XMM sse4
+OVERLAY_ROW_FUNCS
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+OVERLAY_ROW_FUNCS
+%endif
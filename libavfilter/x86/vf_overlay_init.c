@@ -23,43 +23,104 @@
 #include "libavutil/x86/cpu.h"
 #include "libavfilter/vf_overlay.h"
 
-int ff_overlay_row_44_sse4(uint8_t *d, uint8_t *da, uint8_t *s, uint8_t *a,
-                           int w, ptrdiff_t alinesize);
+#define DECLARE_OVERLAY_ROW(name, opt)                                         \
+int ff_overlay_row_##name##_##opt(uint8_t *d, uint8_t *da, uint8_t *s,         \
+                                  uint8_t *a, int w, ptrdiff_t alinesize)
 
-int ff_overlay_row_20_sse4(uint8_t *d, uint8_t *da, uint8_t *s, uint8_t *a,
-                           int w, ptrdiff_t alinesize);
+#define DECLARE_OVERLAY_ROWS(opt)                                              \
+DECLARE_OVERLAY_ROW(44, opt);                                                  \
+DECLARE_OVERLAY_ROW(22, opt);                                                  \
+DECLARE_OVERLAY_ROW(20, opt);                                                  \
+DECLARE_OVERLAY_ROW(20_nv, opt);                                               \
+DECLARE_OVERLAY_ROW(44_pm, opt);                                               \
+DECLARE_OVERLAY_ROW(44_pmc, opt);                                              \
+DECLARE_OVERLAY_ROW(22_pmc, opt);                                              \
+DECLARE_OVERLAY_ROW(20_pmc, opt);                                              \
+DECLARE_OVERLAY_ROW(20_pmc_nv, opt);                                           \
+DECLARE_OVERLAY_ROW(44_10, opt);                                               \
+DECLARE_OVERLAY_ROW(22_10, opt);                                               \
+DECLARE_OVERLAY_ROW(20_10, opt)
 
-int ff_overlay_row_22_sse4(uint8_t *d, uint8_t *da, uint8_t *s, uint8_t *a,
-                           int w, ptrdiff_t alinesize);
+DECLARE_OVERLAY_ROWS(sse4);
+DECLARE_OVERLAY_ROWS(avx2);
+
+#define SET_OVERLAY_ROWS(opt)                                                  \
+do {                                                                           \
+    int nv = pix_format == AV_PIX_FMT_NV12 || pix_format == AV_PIX_FMT_NV21;   \
+                                                                               \
+    if (alpha_format == 0) {                                                   \
+        switch (format) {                                                      \
+        case OVERLAY_FORMAT_YUV444:                                            \
+        case OVERLAY_FORMAT_GBRP:                                              \
+            s->blend_row[0] = ff_overlay_row_44_##opt;                         \
+            s->blend_row[1] = ff_overlay_row_44_##opt;                         \
+            s->blend_row[2] = ff_overlay_row_44_##opt;                         \
+            break;                                                             \
+        case OVERLAY_FORMAT_YUV422:                                            \
+            s->blend_row[0] = ff_overlay_row_44_##opt;                         \
+            s->blend_row[1] = ff_overlay_row_22_##opt;                         \
+            s->blend_row[2] = ff_overlay_row_22_##opt;                         \
+            break;                                                             \
+        case OVERLAY_FORMAT_YUV420:                                            \
+            s->blend_row[0] = ff_overlay_row_44_##opt;                         \
+            s->blend_row[1] = nv ? ff_overlay_row_20_nv_##opt                  \
+                                 : ff_overlay_row_20_##opt;                    \
+            s->blend_row[2] = s->blend_row[1];                                 \
+            break;                                                             \
+        case OVERLAY_FORMAT_YUV444P10:                                         \
+            s->blend_row[0] = ff_overlay_row_44_10_##opt;                      \
+            s->blend_row[1] = ff_overlay_row_44_10_##opt;                      \
+            s->blend_row[2] = ff_overlay_row_44_10_##opt;                      \
+            break;                                                             \
+        case OVERLAY_FORMAT_YUV422P10:                                         \
+            s->blend_row[0] = ff_overlay_row_44_10_##opt;                      \
+            s->blend_row[1] = ff_overlay_row_22_10_##opt;                      \
+            s->blend_row[2] = ff_overlay_row_22_10_##opt;                      \
+            break;                                                             \
+        case OVERLAY_FORMAT_YUV420P10:                                         \
+            s->blend_row[0] = ff_overlay_row_44_10_##opt;                      \
+            s->blend_row[1] = ff_overlay_row_20_10_##opt;                      \
+            s->blend_row[2] = ff_overlay_row_20_10_##opt;                      \
+            break;                                                             \
+        }                                                                      \
+    } else if (alpha_format == 1) {                                            \
+        switch (format) {                                                      \
+        case OVERLAY_FORMAT_GBRP:                                              \
+            s->blend_row[0] = ff_overlay_row_44_pm_##opt;                      \
+            s->blend_row[1] = ff_overlay_row_44_pm_##opt;                      \
+            s->blend_row[2] = ff_overlay_row_44_pm_##opt;                      \
+            break;                                                             \
+        case OVERLAY_FORMAT_YUV444:                                            \
+            s->blend_row[0] = ff_overlay_row_44_pm_##opt;                      \
+            s->blend_row[1] = ff_overlay_row_44_pmc_##opt;                     \
+            s->blend_row[2] = ff_overlay_row_44_pmc_##opt;                     \
+            break;                                                             \
+        case OVERLAY_FORMAT_YUV422:                                            \
+            s->blend_row[0] = ff_overlay_row_44_pm_##opt;                      \
+            s->blend_row[1] = ff_overlay_row_22_pmc_##opt;                     \
+            s->blend_row[2] = ff_overlay_row_22_pmc_##opt;                     \
+            break;                                                             \
+        case OVERLAY_FORMAT_YUV420:                                            \
+            s->blend_row[0] = ff_overlay_row_44_pm_##opt;                      \
+            s->blend_row[1] = nv ? ff_overlay_row_20_pmc_nv_##opt              \
+                                 : ff_overlay_row_20_pmc_##opt;                \
+            s->blend_row[2] = s->blend_row[1];                                 \
+            break;                                                             \
+        }                                                                      \
+    }                                                                          \
+} while (0)
 
 av_cold void ff_overlay_init_x86(OverlayContext *s, int format, int pix_format,
                                  int alpha_format, int main_has_alpha)
 {
     int cpu_flags = av_get_cpu_flags();
 
-    if (EXTERNAL_SSE4(cpu_flags) &&
-        (format == OVERLAY_FORMAT_YUV444 ||
-         format == OVERLAY_FORMAT_GBRP) &&
-        alpha_format == 0 && main_has_alpha == 0) {
-        s->blend_row[0] = ff_overlay_row_44_sse4;
-        s->blend_row[1] = ff_overlay_row_44_sse4;
-        s->blend_row[2] = ff_overlay_row_44_sse4;
-    }
+    if (main_has_alpha)
+        return;
 
-    if (EXTERNAL_SSE4(cpu_flags) &&
-        (pix_format == AV_PIX_FMT_YUV420P) &&
-        (format == OVERLAY_FORMAT_YUV420) &&
-        alpha_format == 0 && main_has_alpha == 0) {
-        s->blend_row[0] = ff_overlay_row_44_sse4;
-        s->blend_row[1] = ff_overlay_row_20_sse4;
-        s->blend_row[2] = ff_overlay_row_20_sse4;
-    }
+    if (EXTERNAL_SSE4(cpu_flags))
+        SET_OVERLAY_ROWS(sse4);
 
-    if (EXTERNAL_SSE4(cpu_flags) &&
-        (format == OVERLAY_FORMAT_YUV422) &&
-        alpha_format == 0 && main_has_alpha == 0) {
-        s->blend_row[0] = ff_overlay_row_44_sse4;
-        s->blend_row[1] = ff_overlay_row_22_sse4;
-        s->blend_row[2] = ff_overlay_row_22_sse4;
-    }
+    if (EXTERNAL_AVX2_FAST(cpu_flags))
+        SET_OVERLAY_ROWS(avx2);
 }
@@ -27,10 +27,13 @@
 #include "internal.h"
 #include "subtitles.h"
 #include "libavutil/bprint.h"
+#include "libavutil/opt.h"
 
 typedef struct ASSContext {
+    const AVClass *class;
     FFDemuxSubtitlesQueue q;
     unsigned readorder;
+    int lazy_load;
 } ASSContext;
 
 static int ass_probe(const AVProbeData *p)
@@ -103,6 +106,32 @@ static int64_t get_line(AVBPrint *buf, FFTextReader *tr)
     return pos;
 }
 
+static int ass_read_event(AVFormatContext *s, AVPacket *pkt,
+                          const FFSubtitlesIndexEntry *e)
+{
+    ASSContext *ass = s->priv_data;
+    AVBPrint line, rline;
+    int64_t ts_start;
+    int duration, res;
+    FFTextReader tr;
+    ff_text_init_avio_utf8(&tr, s->pb);
+
+    av_bprint_init(&line,  0, AV_BPRINT_SIZE_UNLIMITED);
+    av_bprint_init(&rline, 0, AV_BPRINT_SIZE_UNLIMITED);
+
+    get_line(&line, &tr);
+    ass->readorder = e->order;
+    res = read_dialogue(ass, &rline, line.str, &ts_start, &duration);
+    if (res < 0)
+        res = AVERROR_INVALIDDATA;
+    else if ((res = av_new_packet(pkt, rline.len)) >= 0)
+        memcpy(pkt->data, rline.str, rline.len);
+
+    av_bprint_finalize(&line,  NULL);
+    av_bprint_finalize(&rline, NULL);
+    return res;
+}
+
 static int ass_read_header(AVFormatContext *s)
 {
     ASSContext *ass = s->priv_data;
@@ -124,6 +153,8 @@ static int ass_read_header(AVFormatContext *s)
     av_bprint_init(&rline,  0, AV_BPRINT_SIZE_UNLIMITED);
 
     ass->q.keep_duplicates = 1;
+    if (ass->lazy_load && tr.type == FF_UTF_8)
+        ff_subtitles_queue_init_index(&ass->q, s, ass_read_event);
 
     for (;;) {
         int64_t pos = get_line(&line, &tr);
@@ -138,6 +169,17 @@ static int ass_read_header(AVFormatContext *s)
             av_bprintf(&header, "%s", line.str);
             continue;
         }
+        if (ass->q.read_event) {
+            FFSubtitlesIndexEntry *e = ff_subtitles_queue_insert_index(&ass->q, pos, rline.str, rline.len);
+            if (!e) {
+                res = AVERROR(ENOMEM);
+                goto end;
+            }
+            e->pos = pos;
+            e->pts = ts_start;
+            e->duration = duration;
+            continue;
+        }
         sub = ff_subtitles_queue_insert_bprint(&ass->q, &rline, 0);
         if (!sub) {
             res = AVERROR(ENOMEM);
@@ -161,14 +203,51 @@ end:
     return res;
 }
 
+static int ass_read_packet(AVFormatContext *s, AVPacket *pkt)
+{
+    ASSContext *ass = s->priv_data;
+    return ff_subtitles_queue_read_packet(&ass->q, pkt);
+}
+
+static int ass_read_seek(AVFormatContext *s, int stream_index,
+                         int64_t min_ts, int64_t ts, int64_t max_ts, int flags)
+{
+    ASSContext *ass = s->priv_data;
+    return ff_subtitles_queue_seek(&ass->q, s, stream_index,
+                                   min_ts, ts, max_ts, flags);
+}
+
+static int ass_read_close(AVFormatContext *s)
+{
+    ASSContext *ass = s->priv_data;
+    ff_subtitles_queue_clean(&ass->q);
+    return 0;
+}
+
+#define OFFSET(x) offsetof(ASSContext, x)
+#define FLAGS AV_OPT_FLAG_SUBTITLE_PARAM|AV_OPT_FLAG_DECODING_PARAM
+
+static const AVOption options[] = {
+    { "lazy_load", "only index the events when opening and read them on demand", OFFSET(lazy_load), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, FLAGS },
+    { NULL }
+};
+
+static const AVClass ass_demuxer_class = {
+    .class_name  = "ASS demuxer",
+    .item_name   = av_default_item_name,
+    .option      = options,
+    .version     = LIBAVUTIL_VERSION_INT,
+};
+
 const FFInputFormat ff_ass_demuxer = {
     .p.name         = "ass",
     .p.long_name    = NULL_IF_CONFIG_SMALL("SSA (SubStation Alpha) subtitle"),
+    .p.priv_class   = &ass_demuxer_class,
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .priv_data_size = sizeof(ASSContext),
     .read_probe     = ass_probe,
     .read_header    = ass_read_header,
-    .read_packet    = ff_subtitles_read_packet,
-    .read_close     = ff_subtitles_read_close,
-    .read_seek2     = ff_subtitles_read_seek,
+    .read_packet    = ass_read_packet,
+    .read_close     = ass_read_close,
+    .read_seek2     = ass_read_seek,
 };
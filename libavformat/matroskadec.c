@@ -1249,6 +1249,43 @@ static MatroskaLevel1Element *matroska_find_level1_elem(MatroskaDemuxContext *ma
     return elem;
 }
 
+/*
+ * Peek at the track number of a (Simple)Block and check whether the
+ * stream it belongs to is discarded, so that its payload can be skipped
+ * instead of being read. The read position is left unchanged.
+ */
+static int matroska_block_is_discarded(MatroskaDemuxContext *matroska,
+                                       AVIOContext *pb, uint64_t length)
+{
+    MatroskaTrack *tracks = matroska->tracks.elem;
+    int64_t pos = avio_tell(pb);
+    uint8_t head[8];
+    uint64_t num;
+    int i, n, len;
+
+    if (ffio_ensure_seekback(pb, sizeof(head)) < 0)
+        return 0;
+    n = avio_read(pb, head, FFMIN(length, sizeof(head)));
+    if (avio_seek(pb, pos, SEEK_SET) != pos)
+        return 0;
+    if (n < 1 || !head[0])
+        return 0;
+
+    len = 8 - av_log2(head[0]);
+    if (len > n || len + 3 > length)
+        return 0;
+    num = head[0] & (0xff >> len);
+    for (i = 1; i < len; i++)
+        num = (num << 8) | head[i];
+
+    for (i = 0; i < matroska->tracks.nb_elem; i++)
+        if (tracks[i].num == num)
+            return tracks[i].stream &&
+                   tracks[i].stream->discard >= AVDISCARD_ALL;
+
+    return 0;
+}
+
 static int ebml_parse(MatroskaDemuxContext *matroska,
                       EbmlSyntax *syntax, void *data)
 {
@@ -1477,6 +1514,9 @@ static int ebml_parse(MatroskaDemuxContext *matroska,
         res = ebml_read_ascii(pb, length, syntax->def.s, data);
         break;
     case EBML_BIN:
+        if ((id == MATROSKA_ID_SIMPLEBLOCK || id == MATROSKA_ID_BLOCK) &&
+            matroska_block_is_discarded(matroska, pb, length))
+            goto skip;
         res = ebml_read_binary(pb, length, pos_alt, data);
         break;
     case EBML_LEVEL1:
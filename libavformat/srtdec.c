@@ -26,9 +26,12 @@
 #include "subtitles.h"
 #include "libavutil/bprint.h"
 #include "libavutil/intreadwrite.h"
+#include "libavutil/opt.h"
 
 typedef struct {
+    const AVClass *class;
     FFDemuxSubtitlesQueue q;
+    int lazy_load;
 } SRTContext;
 
 static int srt_probe(const AVProbeData *p)
@@ -92,8 +95,8 @@ static int get_event_info(const char *line, struct event_info *ei)
     return -1;
 }
 
-static int add_event(FFDemuxSubtitlesQueue *q, AVBPrint *buf, char *line_cache,
-                     const struct event_info *ei, int append_cache)
+static int add_event(FFDemuxSubtitlesQueue *q, AVPacket *pkt, AVBPrint *buf,
+                     char *line_cache, const struct event_info *ei, int append_cache)
 {
     if (append_cache && line_cache[0])
         av_bprintf(buf, "%s\n", line_cache);
@@ -105,13 +108,33 @@ static int add_event(FFDemuxSubtitlesQueue *q, AVBPrint *buf, char *line_cache,
         buf->str[--buf->len] = 0;
 
     if (buf->len) {
-        AVPacket *sub = ff_subtitles_queue_insert_bprint(q, buf, 0);
-        if (!sub)
-            return AVERROR(ENOMEM);
+        AVPacket *sub = pkt;
+
+        if (!pkt && q->read_event) {
+            FFSubtitlesIndexEntry *e = ff_subtitles_queue_insert_index(q, ei->pos, buf->str, buf->len);
+            if (!e)
+                return AVERROR(ENOMEM);
+            av_bprint_clear(buf);
+            e->pos = ei->pos;
+            e->pts = ei->pts;
+            e->duration = ei->duration;
+            return 0;
+        }
+
+        if (pkt) {
+            int ret = av_new_packet(pkt, buf->len);
+            if (ret < 0)
+                return ret;
+            memcpy(pkt->data, buf->str, buf->len);
+        } else {
+            sub = ff_subtitles_queue_insert_bprint(q, buf, 0);
+            if (!sub)
+                return AVERROR(ENOMEM);
+            sub->pos = ei->pos;
+            sub->pts = ei->pts;
+            sub->duration = ei->duration;
+        }
         av_bprint_clear(buf);
-        sub->pos = ei->pos;
-        sub->pts = ei->pts;
-        sub->duration = ei->duration;
         if (ei->x1 != -1) {
             uint8_t *p = av_packet_new_side_data(sub, AV_PKT_DATA_SUBTITLE_POSITION, 16);
             if (p) {
@@ -126,32 +149,26 @@ static int add_event(FFDemuxSubtitlesQueue *q, AVBPrint *buf, char *line_cache,
     return 0;
 }
 
-static int srt_read_header(AVFormatContext *s)
+/**
+ * Add the events read from tr to the queue, or only read the first one into
+ * pkt if it is not NULL.
+ */
+static int read_events(SRTContext *srt, FFTextReader *tr, AVPacket *pkt)
 {
-    SRTContext *srt = s->priv_data;
     AVBPrint buf;
-    AVStream *st = avformat_new_stream(s, NULL);
     int res = 0;
     char line[4096], line_cache[4096];
     int has_event_info = 0;
     struct event_info ei;
-    FFTextReader tr;
-    ff_text_init_avio(s, &tr, s->pb);
-
-    if (!st)
-        return AVERROR(ENOMEM);
-    avpriv_set_pts_info(st, 64, 1, 1000);
-    st->codecpar->codec_type = AVMEDIA_TYPE_SUBTITLE;
-    st->codecpar->codec_id   = AV_CODEC_ID_SUBRIP;
 
     av_bprint_init(&buf, 0, AV_BPRINT_SIZE_UNLIMITED);
 
     line_cache[0] = 0;
 
-    while (!ff_text_eof(&tr)) {
+    while (!ff_text_eof(tr)) {
         struct event_info tmp_ei;
-        const int64_t pos = ff_text_pos(&tr);
-        ptrdiff_t len = ff_subtitles_read_line(&tr, line, sizeof(line));
+        const int64_t pos = ff_text_pos(tr);
+        ptrdiff_t len = ff_subtitles_read_line(tr, line, sizeof(line));
 
         if (len < 0)
             break;
@@ -187,8 +204,8 @@ static int srt_read_header(AVFormatContext *s)
                  * is empty and the cached line is not a standalone number. */
                 char *pline = NULL;
                 const int standalone_number = strtol(line_cache, &pline, 10) >= 0 && pline && !*pline;
-                res = add_event(&srt->q, &buf, line_cache, &ei, !buf.len && !standalone_number);
-                if (res < 0)
+                res = add_event(&srt->q, pkt, &buf, line_cache, &ei, !buf.len && !standalone_number);
+                if (res < 0 || pkt)
                     goto end;
             } else {
                 has_event_info = 1;
@@ -201,27 +218,94 @@ static int srt_read_header(AVFormatContext *s)
     /* Append the last event. Here we force the cache to be flushed, because a
      * trailing number is more likely to be geniune (for example a copyright
      * date) and not the event index of an inexistant event */
-    if (has_event_info) {
-        res = add_event(&srt->q, &buf, line_cache, &ei, 1);
-        if (res < 0)
-            goto end;
-    }
-
-    ff_subtitles_queue_finalize(s, &srt->q);
+    if (has_event_info)
+        res = add_event(&srt->q, pkt, &buf, line_cache, &ei, 1);
 
 end:
     av_bprint_finalize(&buf, NULL);
     return res;
 }
 
+static int srt_read_event(AVFormatContext *s, AVPacket *pkt,
+                          const FFSubtitlesIndexEntry *e)
+{
+    SRTContext *srt = s->priv_data;
+    FFTextReader tr;
+
+    ff_text_init_avio_utf8(&tr, s->pb);
+    return read_events(srt, &tr, pkt);
+}
+
+static int srt_read_header(AVFormatContext *s)
+{
+    SRTContext *srt = s->priv_data;
+    AVStream *st = avformat_new_stream(s, NULL);
+    int res;
+    FFTextReader tr;
+    ff_text_init_avio(s, &tr, s->pb);
+
+    if (!st)
+        return AVERROR(ENOMEM);
+    avpriv_set_pts_info(st, 64, 1, 1000);
+    st->codecpar->codec_type = AVMEDIA_TYPE_SUBTITLE;
+    st->codecpar->codec_id   = AV_CODEC_ID_SUBRIP;
+
+    if (srt->lazy_load && tr.type == FF_UTF_8)
+        ff_subtitles_queue_init_index(&srt->q, s, srt_read_event);
+
+    res = read_events(srt, &tr, NULL);
+    if (res < 0)
+        return res;
+
+    ff_subtitles_queue_finalize(s, &srt->q);
+    return 0;
+}
+
+static int srt_read_packet(AVFormatContext *s, AVPacket *pkt)
+{
+    SRTContext *srt = s->priv_data;
+    return ff_subtitles_queue_read_packet(&srt->q, pkt);
+}
+
+static int srt_read_seek(AVFormatContext *s, int stream_index,
+                         int64_t min_ts, int64_t ts, int64_t max_ts, int flags)
+{
+    SRTContext *srt = s->priv_data;
+    return ff_subtitles_queue_seek(&srt->q, s, stream_index,
+                                   min_ts, ts, max_ts, flags);
+}
+
+static int srt_read_close(AVFormatContext *s)
+{
+    SRTContext *srt = s->priv_data;
+    ff_subtitles_queue_clean(&srt->q);
+    return 0;
+}
+
+#define OFFSET(x) offsetof(SRTContext, x)
+#define FLAGS AV_OPT_FLAG_SUBTITLE_PARAM|AV_OPT_FLAG_DECODING_PARAM
+
+static const AVOption options[] = {
+    { "lazy_load", "only index the events when opening and read them on demand", OFFSET(lazy_load), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, FLAGS },
+    { NULL }
+};
+
+static const AVClass srt_demuxer_class = {
+    .class_name  = "SRT demuxer",
+    .item_name   = av_default_item_name,
+    .option      = options,
+    .version     = LIBAVUTIL_VERSION_INT,
+};
+
 const FFInputFormat ff_srt_demuxer = {
     .p.name      = "srt",
     .p.long_name = NULL_IF_CONFIG_SMALL("SubRip subtitle"),
+    .p.priv_class = &srt_demuxer_class,
     .priv_data_size = sizeof(SRTContext),
     .flags_internal = FF_INFMT_FLAG_INIT_CLEANUP,
     .read_probe  = srt_probe,
     .read_header = srt_read_header,
-    .read_packet = ff_subtitles_read_packet,
-    .read_seek2  = ff_subtitles_read_seek,
-    .read_close  = ff_subtitles_read_close,
+    .read_packet = srt_read_packet,
+    .read_seek2  = srt_read_seek,
+    .read_close  = srt_read_close,
 };
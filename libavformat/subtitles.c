@@ -21,7 +21,10 @@
 #include "avformat.h"
 #include "subtitles.h"
 #include "avio_internal.h"
+#include "libavutil/avassert.h"
 #include "libavutil/avstring.h"
+#include "libavutil/crc.h"
+#include "libavutil/mem.h"
 
 void ff_text_init_avio(void *s, FFTextReader *r, AVIOContext *pb)
 {
@@ -55,6 +58,13 @@ void ff_text_init_buf(FFTextReader *r, const void *buf, size_t size)
     ff_text_init_avio(NULL, r, &r->buf_pb.pub);
 }
 
+void ff_text_init_avio_utf8(FFTextReader *r, AVIOContext *pb)
+{
+    r->pb = pb;
+    r->buf_pos = r->buf_len = 0;
+    r->type = FF_UTF_8;
+}
+
 int64_t ff_text_pos(FFTextReader *r)
 {
     return avio_tell(r->pb) - r->buf_len + r->buf_pos;
@@ -145,6 +155,47 @@ AVPacket *ff_subtitles_queue_insert(FFDemuxSubtitlesQueue *q,
     return sub;
 }
 
+int ff_subtitles_queue_init_index(FFDemuxSubtitlesQueue *q, AVFormatContext *s,
+                                  int (*read_event)(AVFormatContext *s, AVPacket *pkt,
+                                                    const FFSubtitlesIndexEntry *e))
+{
+    av_assert0(!q->nb_subs);
+    if (!s->pb || !(s->pb->seekable & AVIO_SEEKABLE_NORMAL)) {
+        av_log(s, AV_LOG_VERBOSE, "Input is not seekable, reading all events\n");
+        return AVERROR(ENOSYS);
+    }
+    q->s          = s;
+    q->read_event = read_event;
+    return 0;
+}
+
+FFSubtitlesIndexEntry *ff_subtitles_queue_insert_index(FFDemuxSubtitlesQueue *q,
+                                                       int64_t data_pos,
+                                                       const uint8_t *event, size_t len)
+{
+    FFSubtitlesIndexEntry *index, *e;
+
+    if (q->nb_subs >= INT_MAX/sizeof(*q->index) - 1 || len > INT_MAX)
+        return NULL;
+    index = av_fast_realloc(q->index, &q->allocated_size,
+                            (q->nb_subs + 1) * sizeof(*q->index));
+    if (!index)
+        return NULL;
+    q->index = index;
+    e = &index[q->nb_subs];
+    *e = (FFSubtitlesIndexEntry){
+        .pts      = 0,
+        .duration = -1,
+        .pos      = -1,
+        .data_pos = data_pos,
+        .order    = q->nb_subs,
+        .size     = len,
+        .crc      = av_crc(av_crc_get_table(AV_CRC_32_IEEE_LE), 0, event, len),
+    };
+    q->nb_subs++;
+    return e;
+}
+
 AVPacket *ff_subtitles_queue_insert_bprint(FFDemuxSubtitlesQueue *q,
                                            const AVBPrint *event, int merge)
 {
@@ -174,24 +225,118 @@ static int cmp_pkt_sub_pos_ts(const void *a, const void *b)
     return s1->pos > s2->pos ? 1 : -1;
 }
 
+static int cmp_index_ts_pos(const void *a, const void *b)
+{
+    const FFSubtitlesIndexEntry *e1 = a;
+    const FFSubtitlesIndexEntry *e2 = b;
+    if (e1->pts == e2->pts)
+        return FFDIFFSIGN(e1->pos, e2->pos);
+    return FFDIFFSIGN(e1->pts, e2->pts);
+}
+
+static int cmp_index_pos_ts(const void *a, const void *b)
+{
+    const FFSubtitlesIndexEntry *e1 = a;
+    const FFSubtitlesIndexEntry *e2 = b;
+    if (e1->pos == e2->pos)
+        return FFDIFFSIGN(e1->pts, e2->pts);
+    return FFDIFFSIGN(e1->pos, e2->pos);
+}
+
+static int64_t sub_pts(const FFDemuxSubtitlesQueue *q, int i)
+{
+    return q->index ? q->index[i].pts : q->subs[i]->pts;
+}
+
+static int64_t sub_duration(const FFDemuxSubtitlesQueue *q, int i)
+{
+    return q->index ? q->index[i].duration : q->subs[i]->duration;
+}
+
+static int sub_stream_index(const FFDemuxSubtitlesQueue *q, int i)
+{
+    return q->index ? q->index[i].stream_index : q->subs[i]->stream_index;
+}
+
+static int read_index_entry(FFDemuxSubtitlesQueue *q, AVPacket *pkt, int i)
+{
+    const FFSubtitlesIndexEntry *e = &q->index[i];
+    int64_t ret = avio_seek(q->s->pb, e->data_pos, SEEK_SET);
+
+    if (ret < 0)
+        return ret;
+    ret = q->read_event(q->s, pkt, e);
+    if (ret < 0)
+        return ret;
+    if (pkt->size != e->size) {
+        av_log(q->s, AV_LOG_ERROR, "Event at position %"PRId64" changed since "
+               "the input was indexed\n", e->data_pos);
+        av_packet_unref(pkt);
+        return AVERROR_INVALIDDATA;
+    }
+    pkt->flags       |= AV_PKT_FLAG_KEY;
+    pkt->pts          = e->pts;
+    pkt->duration     = e->duration;
+    pkt->pos          = e->pos;
+    pkt->stream_index = e->stream_index;
+    return 0;
+}
+
+static int is_duplicate(FFDemuxSubtitlesQueue *q, int i, int j)
+{
+    const FFSubtitlesIndexEntry *e1, *e2;
+    AVPacket *pkt1, *pkt2;
+    int dup = 0;
+
+    if (!q->index) {
+        const AVPacket *s1 = q->subs[i];
+        const AVPacket *s2 = q->subs[j];
+
+        return s1->pts          == s2->pts &&
+               s1->duration     == s2->duration &&
+               s1->stream_index == s2->stream_index &&
+               !strcmp(s1->data, s2->data);
+    }
+
+    e1 = &q->index[i];
+    e2 = &q->index[j];
+    if (e1->pts          != e2->pts ||
+        e1->duration     != e2->duration ||
+        e1->stream_index != e2->stream_index ||
+        e1->size         != e2->size ||
+        e1->crc          != e2->crc)
+        return 0;
+
+    /* the checksums match, compare the actual payloads */
+    pkt1 = av_packet_alloc();
+    pkt2 = av_packet_alloc();
+    if (pkt1 && pkt2 &&
+        read_index_entry(q, pkt1, i) >= 0 &&
+        read_index_entry(q, pkt2, j) >= 0)
+        dup = !strcmp(pkt1->data, pkt2->data);
+    av_packet_free(&pkt1);
+    av_packet_free(&pkt2);
+    return dup;
+}
+
 static void drop_dups(void *log_ctx, FFDemuxSubtitlesQueue *q)
 {
     int i, drop = 0;
 
     for (i = 1; i < q->nb_subs; i++) {
         const int last_id = i - 1 - drop;
-        const AVPacket *last = q->subs[last_id];
-
-        if (q->subs[i]->pts        == last->pts &&
-            q->subs[i]->duration   == last->duration &&
-            q->subs[i]->stream_index == last->stream_index &&
-            !strcmp(q->subs[i]->data, last->data)) {
 
-            av_packet_free(&q->subs[i]);
+        if (is_duplicate(q, last_id, i)) {
+            if (!q->index)
+                av_packet_free(&q->subs[i]);
             drop++;
         } else if (drop) {
-            q->subs[last_id + 1] = q->subs[i];
-            q->subs[i] = NULL;
+            if (q->index) {
+                q->index[last_id + 1] = q->index[i];
+            } else {
+                q->subs[last_id + 1] = q->subs[i];
+                q->subs[i] = NULL;
+            }
         }
     }
 
@@ -208,12 +353,23 @@ void ff_subtitles_queue_finalize(void *log_ctx, FFDemuxSubtitlesQueue *q)
     if (!q->nb_subs)
         return;
 
-    qsort(q->subs, q->nb_subs, sizeof(*q->subs),
-          q->sort == SUB_SORT_TS_POS ? cmp_pkt_sub_ts_pos
-                                     : cmp_pkt_sub_pos_ts);
-    for (i = 0; i < q->nb_subs; i++)
-        if (q->subs[i]->duration < 0 && i < q->nb_subs - 1 && q->subs[i + 1]->pts - (uint64_t)q->subs[i]->pts <= INT64_MAX)
-            q->subs[i]->duration = q->subs[i + 1]->pts - q->subs[i]->pts;
+    if (q->index) {
+        qsort(q->index, q->nb_subs, sizeof(*q->index),
+              q->sort == SUB_SORT_TS_POS ? cmp_index_ts_pos
+                                         : cmp_index_pos_ts);
+        for (i = 0; i < q->nb_subs - 1; i++) {
+            FFSubtitlesIndexEntry *e = &q->index[i];
+            if (e->duration < 0 && e[1].pts - (uint64_t)e->pts <= INT64_MAX)
+                e->duration = e[1].pts - e->pts;
+        }
+    } else {
+        qsort(q->subs, q->nb_subs, sizeof(*q->subs),
+              q->sort == SUB_SORT_TS_POS ? cmp_pkt_sub_ts_pos
+                                         : cmp_pkt_sub_pos_ts);
+        for (i = 0; i < q->nb_subs; i++)
+            if (q->subs[i]->duration < 0 && i < q->nb_subs - 1 && q->subs[i + 1]->pts - (uint64_t)q->subs[i]->pts <= INT64_MAX)
+                q->subs[i]->duration = q->subs[i + 1]->pts - q->subs[i]->pts;
+    }
 
     if (!q->keep_duplicates)
         drop_dups(log_ctx, q);
@@ -226,9 +382,14 @@ int ff_subtitles_queue_read_packet(FFDemuxSubtitlesQueue *q, AVPacket *pkt)
 
     if (q->current_sub_idx == q->nb_subs)
         return AVERROR_EOF;
-    sub = q->subs[q->current_sub_idx];
-    if ((ret = av_packet_ref(pkt, sub)) < 0) {
-        return ret;
+    if (q->index) {
+        if ((ret = read_index_entry(q, pkt, q->current_sub_idx)) < 0)
+            return ret;
+    } else {
+        sub = q->subs[q->current_sub_idx];
+        if ((ret = av_packet_ref(pkt, sub)) < 0) {
+            return ret;
+        }
     }
 
     pkt->dts = pkt->pts;
@@ -249,9 +410,9 @@ static int search_sub_ts(const FFDemuxSubtitlesQueue *q, int64_t ts)
         if (s1 == s2)
             return s1;
         if (s1 == s2 - 1)
-            return q->subs[s1]->pts <= q->subs[s2]->pts ? s1 : s2;
+            return sub_pts(q, s1) <= sub_pts(q, s2) ? s1 : s2;
         mid = (s1 + s2) / 2;
-        if (q->subs[mid]->pts <= ts)
+        if (sub_pts(q, mid) <= ts)
             s1 = mid;
         else
             s2 = mid;
@@ -273,24 +434,24 @@ int ff_subtitles_queue_seek(FFDemuxSubtitlesQueue *q, AVFormatContext *s, int st
 
         if (idx < 0)
             return idx;
-        for (i = idx; i < q->nb_subs && q->subs[i]->pts < min_ts; i++)
-            if (stream_index == -1 || q->subs[i]->stream_index == stream_index)
+        for (i = idx; i < q->nb_subs && sub_pts(q, i) < min_ts; i++)
+            if (stream_index == -1 || sub_stream_index(q, i) == stream_index)
                 idx = i;
-        for (i = idx; i > 0 && q->subs[i]->pts > max_ts; i--)
-            if (stream_index == -1 || q->subs[i]->stream_index == stream_index)
+        for (i = idx; i > 0 && sub_pts(q, i) > max_ts; i--)
+            if (stream_index == -1 || sub_stream_index(q, i) == stream_index)
                 idx = i;
 
-        ts_selected = q->subs[idx]->pts;
+        ts_selected = sub_pts(q, idx);
         if (ts_selected < min_ts || ts_selected > max_ts)
             return AVERROR(ERANGE);
 
         /* look back in the latest subtitles for overlapping subtitles */
         for (i = idx - 1; i >= 0; i--) {
-            int64_t pts = q->subs[i]->pts;
-            if (q->subs[i]->duration <= 0 ||
-                (stream_index != -1 && q->subs[i]->stream_index != stream_index))
+            int64_t pts = sub_pts(q, i);
+            if (sub_duration(q, i) <= 0 ||
+                (stream_index != -1 && sub_stream_index(q, i) != stream_index))
                 continue;
-            if (pts >= min_ts && pts > ts_selected - q->subs[i]->duration)
+            if (pts >= min_ts && pts > ts_selected - sub_duration(q, i))
                 idx = i;
             else
                 break;
@@ -302,7 +463,7 @@ int ff_subtitles_queue_seek(FFDemuxSubtitlesQueue *q, AVFormatContext *s, int st
          * queue is ordered by pts and then filepos, so we can take the first
          * entry for a given timestamp. */
         if (stream_index == -1)
-            while (idx > 0 && q->subs[idx - 1]->pts == q->subs[idx]->pts)
+            while (idx > 0 && sub_pts(q, idx - 1) == sub_pts(q, idx))
                 idx--;
 
         q->current_sub_idx = idx;
@@ -314,9 +475,11 @@ void ff_subtitles_queue_clean(FFDemuxSubtitlesQueue *q)
 {
     int i;
 
-    for (i = 0; i < q->nb_subs; i++)
-        av_packet_free(&q->subs[i]);
+    if (q->subs)
+        for (i = 0; i < q->nb_subs; i++)
+            av_packet_free(&q->subs[i]);
     av_freep(&q->subs);
+    av_freep(&q->index);
     q->nb_subs = q->allocated_size = q->current_sub_idx = 0;
 }
 
@@ -437,9 +600,7 @@ int ff_subtitles_read_text_chunk(FFTextReader *tr, AVBPrint *buf)
 int ff_subtitles_read_chunk(AVIOContext *pb, AVBPrint *buf)
 {
     FFTextReader tr;
-    tr.buf_pos = tr.buf_len = 0;
-    tr.type = 0;
-    tr.pb = pb;
+    ff_text_init_avio_utf8(&tr, pb);
     return ff_subtitles_read_text_chunk(&tr, buf);
 }
 
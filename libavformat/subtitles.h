@@ -70,6 +70,15 @@ void ff_text_init_avio(void *s, FFTextReader *r, AVIOContext *pb);
  */
 void ff_text_init_buf(FFTextReader *r, const void *buf, size_t size);
 
+/**
+ * Similar to ff_text_init_avio(), but reads UTF-8 from the current position
+ * of pb without looking for a BOM.
+ *
+ * @param r object which will be initialized
+ * @param pb stream to read from (referenced as long as FFTextReader is in use)
+ */
+void ff_text_init_avio_utf8(FFTextReader *r, AVIOContext *pb);
+
 /**
  * Return the byte position of the next byte returned by ff_text_r8(). For
  * UTF-16 source streams, this will return the original position, but it will
@@ -100,6 +109,21 @@ int ff_text_peek_r8(FFTextReader *r);
  */
 void ff_text_read(FFTextReader *r, char *buf, size_t size);
 
+/**
+ * Subtitle event whose payload is left in the input, see
+ * ff_subtitles_queue_init_index().
+ */
+typedef struct FFSubtitlesIndexEntry {
+    int64_t pts;
+    int64_t duration;
+    int64_t pos;            ///< byte position exported in the packet
+    int64_t data_pos;       ///< byte position the event is read back from
+    int stream_index;
+    unsigned order;         ///< insertion order of the event
+    int size;               ///< size of the payload
+    uint32_t crc;           ///< CRC of the payload, to detect duplicates
+} FFSubtitlesIndexEntry;
+
 typedef struct {
     AVPacket **subs;         ///< array of subtitles packets
     int nb_subs;            ///< number of subtitles packets
@@ -107,8 +131,41 @@ typedef struct {
     int current_sub_idx;    ///< current position for the read packet callback
     enum sub_sort sort;     ///< sort method to use when finalizing subtitles
     int keep_duplicates;    ///< set to 1 to keep duplicated subtitle events
+
+    FFSubtitlesIndexEntry *index; ///< array of events, used instead of subs in index mode
+    AVFormatContext *s;
+    int (*read_event)(AVFormatContext *s, AVPacket *pkt,
+                      const FFSubtitlesIndexEntry *e);
 } FFDemuxSubtitlesQueue;
 
+/**
+ * Switch an empty queue to index mode: events are added with
+ * ff_subtitles_queue_insert_index(), only their timing and position are
+ * kept in memory, and their payload is read back from the input when they
+ * are returned by ff_subtitles_queue_read_packet().
+ *
+ * @param read_event callback filling the payload and side data of pkt with
+ *                   the event e; s->pb is at e->data_pos when it is called
+ * @return 0 on success, AVERROR(ENOSYS) if the input is not seekable, in
+ *         which case the queue is left unchanged
+ */
+int ff_subtitles_queue_init_index(FFDemuxSubtitlesQueue *q, AVFormatContext *s,
+                                  int (*read_event)(AVFormatContext *s, AVPacket *pkt,
+                                                    const FFSubtitlesIndexEntry *e));
+
+/**
+ * Insert a new subtitle event in a queue in index mode. The caller must set
+ * the timing and pos fields of the returned entry.
+ *
+ * @param data_pos position of the event in the input, passed back to the
+ *                 read_event callback
+ * @param event    the payload of the event, only used to detect duplicates
+ * @param len      the length of the payload
+ */
+FFSubtitlesIndexEntry *ff_subtitles_queue_insert_index(FFDemuxSubtitlesQueue *q,
+                                                       int64_t data_pos,
+                                                       const uint8_t *event, size_t len);
+
 /**
  * Insert a new subtitle event.
  *
@@ -36,8 +36,15 @@ typedef struct {
     const AVClass *class;
     FFDemuxSubtitlesQueue q;
     int kind;
+    int lazy_load;
 } WebVTTContext;
 
+typedef struct WebVTTCue {
+    const char *identifier, *settings, *payload;
+    size_t identifier_len, settings_len;
+    int64_t ts_start, ts_end;
+} WebVTTCue;
+
 static int webvtt_probe(const AVProbeData *p)
 {
     const uint8_t *ptr = p->buf;
@@ -58,6 +65,110 @@ static int64_t read_ts(const char *s)
     return AV_NOPTS_VALUE;
 }
 
+/**
+ * Split a chunk into the parts of a cue.
+ *
+ * @return 0 on success, 1 if the chunk is not a cue, a negative value if the
+ *         cue is invalid
+ */
+static int parse_cue(const char *p, WebVTTCue *c)
+{
+    int i;
+
+    c->identifier = p;
+
+    /* ignore header chunk */
+    if (!strncmp(p, "\xEF\xBB\xBFWEBVTT", 9) ||
+        !strncmp(p, "WEBVTT", 6) ||
+        !strncmp(p, "STYLE", 5) ||
+        !strncmp(p, "REGION", 6) ||
+        !strncmp(p, "NOTE", 4))
+        return 1;
+
+    /* optional cue identifier (can be a number like in SRT or some kind of
+     * chaptering id) */
+    for (i = 0; p[i] && p[i] != '\n' && p[i] != '\r'; i++) {
+        if (!strncmp(p + i, "-->", 3)) {
+            c->identifier = NULL;
+            break;
+        }
+    }
+    if (!c->identifier)
+        c->identifier_len = 0;
+    else {
+        c->identifier_len = strcspn(p, "\r\n");
+        p += c->identifier_len;
+        if (*p == '\r')
+            p++;
+        if (*p == '\n')
+            p++;
+    }
+
+    /* cue timestamps */
+    if ((c->ts_start = read_ts(p)) == AV_NOPTS_VALUE)
+        return AVERROR_INVALIDDATA;
+    if (!(p = strstr(p, "-->")))
+        return AVERROR_INVALIDDATA;
+    p += 2;
+    do p++; while (*p == ' ' || *p == '\t');
+    if ((c->ts_end = read_ts(p)) == AV_NOPTS_VALUE)
+        return AVERROR_INVALIDDATA;
+
+    /* optional cue settings */
+    p += strcspn(p, "\n\r\t ");
+    while (*p == '\t' || *p == ' ')
+        p++;
+    c->settings = p;
+    c->settings_len = strcspn(p, "\r\n");
+    p += c->settings_len;
+    if (*p == '\r')
+        p++;
+    if (*p == '\n')
+        p++;
+
+    c->payload = p;
+    return 0;
+}
+
+static int set_side_data(AVPacket *pkt, const WebVTTCue *c)
+{
+#define SET_SIDE_DATA(name, type) do {                                  \
+    if (c->name##_len) {                                                \
+        uint8_t *buf = av_packet_new_side_data(pkt, type, c->name##_len); \
+        if (!buf)                                                       \
+            return AVERROR(ENOMEM);                                     \
+        memcpy(buf, c->name, c->name##_len);                            \
+    }                                                                   \
+} while (0)
+
+    SET_SIDE_DATA(identifier, AV_PKT_DATA_WEBVTT_IDENTIFIER);
+    SET_SIDE_DATA(settings,   AV_PKT_DATA_WEBVTT_SETTINGS);
+    return 0;
+}
+
+static int webvtt_read_event(AVFormatContext *s, AVPacket *pkt,
+                             const FFSubtitlesIndexEntry *e)
+{
+    AVBPrint cue;
+    WebVTTCue c;
+    int res;
+
+    av_bprint_init(&cue, 0, AV_BPRINT_SIZE_UNLIMITED);
+
+    res = ff_subtitles_read_chunk(s->pb, &cue);
+    if (res >= 0 && parse_cue(cue.str, &c))
+        res = AVERROR_INVALIDDATA;
+    if (res >= 0)
+        res = av_new_packet(pkt, strlen(c.payload));
+    if (res >= 0) {
+        memcpy(pkt->data, c.payload, pkt->size);
+        res = set_side_data(pkt, &c);
+    }
+
+    av_bprint_finalize(&cue, NULL);
+    return res;
+}
+
 static int webvtt_read_header(AVFormatContext *s)
 {
     WebVTTContext *webvtt = s->priv_data;
@@ -72,15 +183,16 @@ static int webvtt_read_header(AVFormatContext *s)
     st->codecpar->codec_id   = AV_CODEC_ID_WEBVTT;
     st->disposition |= webvtt->kind;
 
+    if (webvtt->lazy_load)
+        ff_subtitles_queue_init_index(&webvtt->q, s, webvtt_read_event);
+
     av_bprint_init(&cue,    0, AV_BPRINT_SIZE_UNLIMITED);
 
     for (;;) {
-        int i;
-        int64_t pos;
+        int ret;
+        int64_t pos, data_pos = avio_tell(s->pb);
         AVPacket *sub;
-        const char *p, *identifier, *settings;
-        size_t identifier_len, settings_len;
-        int64_t ts_start, ts_end;
+        WebVTTCue c;
 
         res = ff_subtitles_read_chunk(s->pb, &cue);
         if (res < 0)
@@ -89,81 +201,39 @@ static int webvtt_read_header(AVFormatContext *s)
         if (!cue.len)
             break;
 
-        p = identifier = cue.str;
         pos = avio_tell(s->pb);
 
-        /* ignore header chunk */
-        if (!strncmp(p, "\xEF\xBB\xBFWEBVTT", 9) ||
-            !strncmp(p, "WEBVTT", 6) ||
-            !strncmp(p, "STYLE", 5) ||
-            !strncmp(p, "REGION", 6) ||
-            !strncmp(p, "NOTE", 4))
+        ret = parse_cue(cue.str, &c);
+        if (ret > 0)
             continue;
-
-        /* optional cue identifier (can be a number like in SRT or some kind of
-         * chaptering id) */
-        for (i = 0; p[i] && p[i] != '\n' && p[i] != '\r'; i++) {
-            if (!strncmp(p + i, "-->", 3)) {
-                identifier = NULL;
-                break;
-            }
-        }
-        if (!identifier)
-            identifier_len = 0;
-        else {
-            identifier_len = strcspn(p, "\r\n");
-            p += identifier_len;
-            if (*p == '\r')
-                p++;
-            if (*p == '\n')
-                p++;
-        }
-
-        /* cue timestamps */
-        if ((ts_start = read_ts(p)) == AV_NOPTS_VALUE)
-            break;
-        if (!(p = strstr(p, "-->")))
-            break;
-        p += 2;
-        do p++; while (*p == ' ' || *p == '\t');
-        if ((ts_end = read_ts(p)) == AV_NOPTS_VALUE)
+        if (ret < 0)
             break;
 
-        /* optional cue settings */
-        p += strcspn(p, "\n\r\t ");
-        while (*p == '\t' || *p == ' ')
-            p++;
-        settings = p;
-        settings_len = strcspn(p, "\r\n");
-        p += settings_len;
-        if (*p == '\r')
-            p++;
-        if (*p == '\n')
-            p++;
-
         /* create packet */
-        sub = ff_subtitles_queue_insert(&webvtt->q, p, strlen(p), 0);
+        if (webvtt->q.read_event) {
+            FFSubtitlesIndexEntry *e = ff_subtitles_queue_insert_index(&webvtt->q, data_pos,
+                                                                       c.payload, strlen(c.payload));
+            if (!e) {
+                res = AVERROR(ENOMEM);
+                goto end;
+            }
+            e->pos = pos;
+            e->pts = c.ts_start;
+            e->duration = c.ts_end - c.ts_start;
+            continue;
+        }
+        sub = ff_subtitles_queue_insert(&webvtt->q, c.payload, strlen(c.payload), 0);
         if (!sub) {
             res = AVERROR(ENOMEM);
             goto end;
         }
         sub->pos = pos;
-        sub->pts = ts_start;
-        sub->duration = ts_end - ts_start;
+        sub->pts = c.ts_start;
+        sub->duration = c.ts_end - c.ts_start;
 
-#define SET_SIDE_DATA(name, type) do {                                  \
-    if (name##_len) {                                                   \
-        uint8_t *buf = av_packet_new_side_data(sub, type, name##_len);  \
-        if (!buf) {                                                     \
-            res = AVERROR(ENOMEM);                                      \
-            goto end;                                                   \
-        }                                                               \
-        memcpy(buf, name, name##_len);                                  \
-    }                                                                   \
-} while (0)
-
-        SET_SIDE_DATA(identifier, AV_PKT_DATA_WEBVTT_IDENTIFIER);
-        SET_SIDE_DATA(settings,   AV_PKT_DATA_WEBVTT_SETTINGS);
+        res = set_side_data(sub, &c);
+        if (res < 0)
+            goto end;
     }
 
     ff_subtitles_queue_finalize(s, &webvtt->q);
@@ -203,6 +273,7 @@ static const AVOption options[] = {
         { "captions",     "WebVTT captions kind",     0, AV_OPT_TYPE_CONST, { .i64 = AV_DISPOSITION_CAPTIONS },     INT_MIN, INT_MAX, KIND_FLAGS, .unit = "webvtt_kind" },
         { "descriptions", "WebVTT descriptions kind", 0, AV_OPT_TYPE_CONST, { .i64 = AV_DISPOSITION_DESCRIPTIONS }, INT_MIN, INT_MAX, KIND_FLAGS, .unit = "webvtt_kind" },
         { "metadata",     "WebVTT metadata kind",     0, AV_OPT_TYPE_CONST, { .i64 = AV_DISPOSITION_METADATA },     INT_MIN, INT_MAX, KIND_FLAGS, .unit = "webvtt_kind" },
+    { "lazy_load", "only index the events when opening and read them on demand", OFFSET(lazy_load), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, KIND_FLAGS },
     { NULL }
 };
 
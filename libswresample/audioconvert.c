@@ -88,6 +88,19 @@ CONV_FUNC(AV_SAMPLE_FMT_S64, int64_t, AV_SAMPLE_FMT_DBL, llrint(*(const double*)
 CONV_FUNC(AV_SAMPLE_FMT_FLT, float  , AV_SAMPLE_FMT_DBL, *(const double*)pi)
 CONV_FUNC(AV_SAMPLE_FMT_DBL, double , AV_SAMPLE_FMT_DBL, *(const double*)pi)
 
+#define DITHER_FUNC(ofmt, otype, expr)\
+static void conv_dither_AV_SAMPLE_FMT_FLT_to_ ## ofmt(uint8_t *po, const uint8_t *pi, const float *noise, int os, uint8_t *end)\
+{\
+    const float *src = (const float *)pi;\
+    while(po < end){\
+        const float v = *src++ + *noise++;\
+        *(otype*)po = expr; po += os;\
+    }\
+}
+
+DITHER_FUNC(AV_SAMPLE_FMT_S16, int16_t, av_clip_int16(  lrintf(v * (1<<15))))
+DITHER_FUNC(AV_SAMPLE_FMT_S32, int32_t, av_clipl_int32(llrintf(v * (1U<<31))))
+
 #define FMT_PAIR_FUNC(out, in) [(out) + AV_SAMPLE_FMT_NB*(in)] = CONV_FUNC_NAME(out, in)
 
 static conv_func_type * const fmt_pair_to_conv_functions[AV_SAMPLE_FMT_NB*AV_SAMPLE_FMT_NB] = {
@@ -167,6 +180,13 @@ AudioConvert *swri_audio_convert_alloc(enum AVSampleFormat out_fmt,
     if (in_fmt == AV_SAMPLE_FMT_U8 || in_fmt == AV_SAMPLE_FMT_U8P)
         memset(ctx->silence, 0x80, sizeof(ctx->silence));
 
+    if (in_fmt == AV_SAMPLE_FMT_FLTP && !ch_map) {
+        switch (av_get_packed_sample_fmt(out_fmt)) {
+        case AV_SAMPLE_FMT_S16: ctx->dither_f = conv_dither_AV_SAMPLE_FMT_FLT_to_AV_SAMPLE_FMT_S16; break;
+        case AV_SAMPLE_FMT_S32: ctx->dither_f = conv_dither_AV_SAMPLE_FMT_FLT_to_AV_SAMPLE_FMT_S32; break;
+        }
+    }
+
     if(out_fmt == in_fmt && !ch_map) {
         switch(av_get_bytes_per_sample(in_fmt)){
             case 1:ctx->simd_f = cpy1; break;
@@ -249,3 +269,41 @@ int swri_audio_convert(AudioConvert *ctx, AudioData *out, AudioData *in, int len
     }
     return 0;
 }
+
+int swri_audio_convert_dither(AudioConvert *ctx, AudioData *out, const AudioData *in,
+                              const AudioData *noise, int noise_pos, int len)
+{
+    const uint8_t *pn[SWR_CH_MAX];
+    const int os= (out->planar ? 1 :out->ch_count) *out->bps;
+    int ch;
+    int off=0;
+
+    av_assert0(ctx->dither_f && in->planar && noise->bps == 4);
+    av_assert0(ctx->channels == out->ch_count);
+
+    for(ch=0; ch<ctx->channels; ch++)
+        pn[ch] = noise->ch[ch] + noise_pos * noise->bps;
+
+    if(ctx->simd_dither_f){
+        off = len&~15;
+        if(off>0){
+            if(out->planar){
+                for(ch=0; ch<ctx->channels; ch++)
+                    ctx->simd_dither_f(out->ch+ch, (const uint8_t **)in->ch+ch, pn+ch, off);
+            }else{
+                ctx->simd_dither_f(out->ch, (const uint8_t **)in->ch, pn, off);
+            }
+        }
+        if(off == len)
+            return 0;
+    }
+
+    for(ch=0; ch<ctx->channels; ch++){
+        uint8_t *po = out->ch[ch];
+        if(!po)
+            continue;
+        ctx->dither_f(po + off*os, in->ch[ch] + off*in->bps,
+                      (const float *)pn[ch] + off, os, po + os*len);
+    }
+    return 0;
+}
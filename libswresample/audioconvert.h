@@ -34,6 +34,8 @@
 
 typedef void (conv_func_type)(uint8_t *po, const uint8_t *pi, int is, int os, uint8_t *end);
 typedef void (simd_func_type)(uint8_t **dst, const uint8_t **src, int len);
+typedef void (dither_func_type)(uint8_t *po, const uint8_t *pi, const float *noise, int os, uint8_t *end);
+typedef void (simd_dither_func_type)(uint8_t **dst, const uint8_t **src, const uint8_t **noise, int len);
 
 typedef struct AudioConvert {
     int channels;
@@ -41,6 +43,8 @@ typedef struct AudioConvert {
     int out_simd_align_mask;
     conv_func_type *conv_f;
     simd_func_type *simd_f;
+    dither_func_type *dither_f;             ///< planar float input, noise added before conversion
+    simd_dither_func_type *simd_dither_f;
     const int *ch_map;
     uint8_t silence[8]; ///< silence input sample
 }AudioConvert;
@@ -74,4 +78,15 @@ void swri_audio_convert_free(AudioConvert **ctx);
  */
 int swri_audio_convert(AudioConvert *ctx, AudioData *out, AudioData *in, int len);
 
+/**
+ * Add dither noise and convert in one pass, this gives the same output as
+ * adding the noise to the input and calling swri_audio_convert().
+ * Only available if ctx->dither_f is set.
+ * @param[in] in array of planar float input buffers for each channel
+ * @param[in] noise planar float noise, read from sample noise_pos on
+ * @param len length of audio frame size (measured in samples)
+ */
+int swri_audio_convert_dither(AudioConvert *ctx, AudioData *out, const AudioData *in,
+                              const AudioData *noise, int noise_pos, int len);
+
 #endif /* SWRESAMPLE_AUDIOCONVERT_H */
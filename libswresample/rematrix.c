@@ -21,6 +21,7 @@
 #include "swresample_internal.h"
 #include "libavutil/avassert.h"
 #include "libavutil/channel_layout.h"
+#include "libavutil/intreadwrite.h"
 
 #define TEMPLATE_REMATRIX_FLT
 #include "rematrix_template.c"
@@ -557,6 +558,30 @@ av_cold void swri_rematrix_free(SwrContext *s){
     av_freep(&s->native_one);
     av_freep(&s->native_simd_matrix);
     av_freep(&s->native_simd_one);
+    av_freep(&s->native_simd_n_matrix);
+}
+
+/**
+ * The int16 mix_n_1_simd arithmetic in C, for the samples after the SIMD
+ * part: 16 bit coefficients applied to input pairs, with 32 bit wraparound,
+ * then rounded, shifted and saturated. The C loop below uses the unscaled
+ * 32 bit coefficients, so using it for the tail would make the output depend
+ * on the sample position.
+ */
+static void mix_n_1_int16_c(int16_t *out, const void **in, const uint8_t *coeffp,
+                            int nb, int start, int len)
+{
+    int shift = AV_RN32(coeffp);
+    const int16_t *coeff = (const int16_t *)(coeffp + 4);
+    const int16_t **src = (const int16_t **)in;
+
+    for (int i = start; i < len; i++) {
+        uint32_t v = 0;
+        for (int j = 0; j < nb; j += 2)
+            v += (uint32_t)(src[j][i] * coeff[j]) + (uint32_t)(src[j + 1][i] * coeff[j + 1]);
+        v += (1U << shift) >> 1;
+        out[i] = av_clip_int16((int32_t)v >> shift);
+    }
 }
 
 int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mustcopy){
@@ -569,7 +594,7 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
         return 0;
     }
 
-    if(s->mix_2_1_simd || s->mix_1_1_simd){
+    if(s->mix_2_1_simd || s->mix_1_1_simd || s->mix_n_1_simd){
         len1= len&~15;
         off = len1 * out->bps;
     }
@@ -588,6 +613,8 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
             if(s->matrix[out_i][in_i]!=1.0){
                 if(s->mix_1_1_simd && len1)
                     s->mix_1_1_simd(out->ch[out_i]    , in->ch[in_i]    , s->native_simd_matrix, in->ch_count*out_i + in_i, len1);
+                else
+                    s->mix_1_1_f   (out->ch[out_i]    , in->ch[in_i]    , s->native_matrix, in->ch_count*out_i + in_i, len1);
                 if(len != len1)
                     s->mix_1_1_f   (out->ch[out_i]+off, in->ch[in_i]+off, s->native_matrix, in->ch_count*out_i + in_i, len-len1);
             }else if(mustcopy){
@@ -606,9 +633,27 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
             if(len != len1)
                 s->mix_2_1_f   (out->ch[out_i]+off, in->ch[in_i1]+off, in->ch[in_i2]+off, s->native_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len-len1);
             break;}
-        default:
+        default: {
+            int start = 0;
+
+            if(s->mix_n_1_simd){
+                const void *ins[SWR_CH_MAX + 1];
+                uint8_t *coeffp = s->native_simd_n_matrix + out_i * (SWR_CH_MAX + 1) * 4;
+                int nb = s->matrix_ch[out_i][0];
+
+                for(j=0; j<nb; j++)
+                    ins[j]= in->ch[s->matrix_ch[out_i][1+j]];
+                ins[nb]= ins[nb-1];
+                if(len1)
+                    s->mix_n_1_simd(out->ch[out_i], ins, coeffp, nb, len1);
+                start = len1;
+                if(s->int_sample_fmt == AV_SAMPLE_FMT_S16P){
+                    mix_n_1_int16_c((int16_t*)out->ch[out_i], ins, coeffp, nb, start, len);
+                    break;
+                }
+            }
             if(s->int_sample_fmt == AV_SAMPLE_FMT_FLTP){
-                for(i=0; i<len; i++){
+                for(i=start; i<len; i++){
                     float v=0;
                     for(j=0; j<s->matrix_ch[out_i][0]; j++){
                         in_i= s->matrix_ch[out_i][1+j];
@@ -617,7 +662,7 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
                     ((float*)out->ch[out_i])[i]= v;
                 }
             }else if(s->int_sample_fmt == AV_SAMPLE_FMT_DBLP){
-                for(i=0; i<len; i++){
+                for(i=start; i<len; i++){
                     double v=0;
                     for(j=0; j<s->matrix_ch[out_i][0]; j++){
                         in_i= s->matrix_ch[out_i][1+j];
@@ -625,8 +670,17 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
                     }
                     ((double*)out->ch[out_i])[i]= v;
                 }
+            }else if(s->int_sample_fmt == AV_SAMPLE_FMT_S32P){
+                for(i=start; i<len; i++){
+                    int64_t v=0;
+                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
+                        in_i= s->matrix_ch[out_i][1+j];
+                        v+= ((int32_t*)in->ch[in_i])[i] * (int64_t)s->matrix32[out_i][in_i];
+                    }
+                    ((int32_t*)out->ch[out_i])[i]= (v + 16384)>>15;
+                }
             }else{
-                for(i=0; i<len; i++){
+                for(i=start; i<len; i++){
                     int v=0;
                     for(j=0; j<s->matrix_ch[out_i][0]; j++){
                         in_i= s->matrix_ch[out_i][1+j];
@@ -635,6 +689,7 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
                     ((int16_t*)out->ch[out_i])[i]= (v + 16384)>>15;
                 }
             }
+            break;}
         }
     }
     return 0;
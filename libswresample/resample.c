@@ -177,13 +177,35 @@ static void resample_free(ResampleContext **cc){
     ResampleContext *c = *cc;
     if(!c)
         return;
+    avpriv_slicethread_free(&c->slicethread);
     av_freep(&c->filter_bank);
     av_freep(cc);
 }
 
+static void resample_worker(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    ResampleContext *c = priv;
+    const int ch_count = c->job.dst->ch_count;
+    const int start = ch_count *  jobnr      / nb_jobs;
+    const int end   = ch_count * (jobnr + 1) / nb_jobs;
+
+    for (int i = start; i < end; i++) {
+        if (i + 1 == ch_count) {
+            /* the other channels still read index and frac from c,
+             * so advance a copy and commit it after all jobs are done */
+            ResampleContext tmp = *c;
+            c->job.consumed = c->job.func(&tmp, c->job.dst->ch[i], c->job.src->ch[i], c->job.n, 1);
+            c->job.index    = tmp.index;
+            c->job.frac     = tmp.frac;
+        } else
+            c->job.func(c, c->job.dst->ch[i], c->job.src->ch[i], c->job.n, 0);
+    }
+}
+
 static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_rate, int filter_size, int phase_shift, int linear,
                                     double cutoff0, enum AVSampleFormat format, enum SwrFilterType filter_type, double kaiser_beta,
-                                    double precision, int cheby, int exact_rational)
+                                    double precision, int cheby, int exact_rational,
+                                    int nb_threads)
 {
     double cutoff = cutoff0? cutoff0 : 0.97;
     double factor= FFMIN(out_rate * cutoff / in_rate, 1.0);
@@ -268,10 +290,22 @@ static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_r
     c->index= -phase_count*((c->filter_length-1)/2);
     c->frac= 0;
 
+    if (c->slicethread && c->threads != nb_threads)
+        avpriv_slicethread_free(&c->slicethread);
+    c->threads = nb_threads;
+    if (nb_threads != 1 && !c->slicethread) {
+        int ret = avpriv_slicethread_create(&c->slicethread, c, resample_worker, NULL, nb_threads);
+        if (ret < 0 && ret != AVERROR(ENOSYS))
+            goto error;
+        c->nb_threads = FFMAX(ret, 1);
+    } else if (!c->slicethread)
+        c->nb_threads = 1;
+
     swri_resample_dsp_init(c);
 
     return c;
 error:
+    avpriv_slicethread_free(&c->slicethread);
     av_freep(&c->filter_bank);
     av_free(c);
     return NULL;
@@ -388,8 +422,19 @@ static int multiple_resample(ResampleContext *c, AudioData *dst, int dst_size, A
              * when frac and dst_incr_mod are zero */
             resample_func = (c->linear && (c->frac || c->dst_incr_mod)) ?
                             c->dsp.resample_linear : c->dsp.resample_common;
-            for (i = 0; i < dst->ch_count; i++)
-                *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, i+1 == dst->ch_count);
+            if (c->slicethread && dst->ch_count > 1) {
+                c->job.func = resample_func;
+                c->job.dst  = dst;
+                c->job.src  = src;
+                c->job.n    = dst_size;
+                avpriv_slicethread_execute(c->slicethread, FFMIN(dst->ch_count, c->nb_threads), 0);
+                c->index  = c->job.index;
+                c->frac   = c->job.frac;
+                *consumed = c->job.consumed;
+            } else {
+                for (i = 0; i < dst->ch_count; i++)
+                    *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, i+1 == dst->ch_count);
+            }
         }
     }
 
@@ -24,6 +24,7 @@
 
 #include "libavutil/log.h"
 #include "libavutil/samplefmt.h"
+#include "libavutil/slicethread.h"
 
 #include "swresample_internal.h"
 
@@ -50,6 +51,22 @@ typedef struct ResampleContext {
     int filter_shift;
     int phase_count_compensation;      /* desired phase_count when compensation is enabled */
 
+    AVSliceThread *slicethread;
+    int threads;                       /* requested number of threads, 0 for automatic */
+    int nb_threads;                    /* number of threads actually used */
+
+    /* arguments and results of the channel-parallel resampling jobs */
+    struct {
+        int (*func)(struct ResampleContext *c, void *dst,
+                    const void *src, int n, int update_ctx);
+        AudioData *dst;
+        const AudioData *src;
+        int n;
+        int consumed;
+        int index;
+        int frac;
+    } job;
+
     struct {
         void (*resample_one)(void *dst, const void *src,
                              int n, int64_t index, int64_t incr);
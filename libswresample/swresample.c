@@ -277,7 +277,7 @@ av_cold int swr_init(struct SwrContext *s){
     }
 
     if (s->out_sample_rate!=s->in_sample_rate || (s->flags & SWR_FLAG_RESAMPLE)){
-        s->resample = s->resampler->init(s->resample, s->out_sample_rate, s->in_sample_rate, s->filter_size, s->phase_shift, s->linear_interp, s->cutoff, s->int_sample_fmt, s->filter_type, s->kaiser_beta, s->precision, s->cheby, s->exact_rational);
+        s->resample = s->resampler->init(s->resample, s->out_sample_rate, s->in_sample_rate, s->filter_size, s->phase_shift, s->linear_interp, s->cutoff, s->int_sample_fmt, s->filter_type, s->kaiser_beta, s->precision, s->cheby, s->exact_rational, s->nb_threads);
         if (!s->resample) {
             av_log(s, AV_LOG_ERROR, "Failed to initialize resampler\n");
             return AVERROR(ENOMEM);
@@ -659,11 +659,14 @@ static int swr_convert_internal(struct SwrContext *s, AudioData *out, int out_co
 
     if(preout != out && out_count){
         AudioData *conv_src = preout;
+        int dither_convert = 0;
         if(s->dither.method){
             int ch;
             int dither_count= FFMAX(out_count, 1<<16);
 
-            if (preout == in) {
+            dither_convert = s->dither.method < SWR_DITHER_NS && s->out_convert->dither_f;
+
+            if (preout == in && !dither_convert) {
                 conv_src = &s->dither.temp;
                 if((ret=swri_realloc_audio(&s->dither.temp, dither_count))<0)
                     return ret;
@@ -680,7 +683,9 @@ static int swr_convert_internal(struct SwrContext *s, AudioData *out, int out_co
             if(s->dither.noise_pos + out_count > s->dither.noise.count)
                 s->dither.noise_pos = 0;
 
-            if (s->dither.method < SWR_DITHER_NS){
+            if (dither_convert) {
+                swri_audio_convert_dither(s->out_convert, out, preout, &s->dither.noise, s->dither.noise_pos, out_count);
+            } else if (s->dither.method < SWR_DITHER_NS){
                 if (s->mix_2_1_simd) {
                     int len1= out_count&~15;
                     int off = len1 * preout->bps;
@@ -706,7 +711,8 @@ static int swr_convert_internal(struct SwrContext *s, AudioData *out, int out_co
             s->dither.noise_pos += out_count;
         }
 //FIXME packed doesn't need more than 1 chan here!
-        swri_audio_convert(s->out_convert, out, conv_src, out_count);
+        if (!dither_convert)
+            swri_audio_convert(s->out_convert, out, conv_src, out_count);
     }
     return out_count;
 }
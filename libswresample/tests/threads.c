@@ -0,0 +1,177 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Check that channel-parallel resampling gives the same output as
+ * resampling on a single thread, and report the time taken by both.
+ *
+ * Usage: threads [in_rate out_rate channels threads seconds [sample_fmt]]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/channel_layout.h"
+#include "libavutil/lfg.h"
+#include "libavutil/macros.h"
+#include "libavutil/mathematics.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/samplefmt.h"
+#include "libavutil/time.h"
+#include "libswresample/swresample.h"
+
+#define FRAME_SIZE 1024
+
+static int run(enum AVSampleFormat fmt, int in_rate, int out_rate, int channels,
+               int threads, int seconds, uint8_t **in, uint8_t ***pout,
+               int *out_size, int64_t *time)
+{
+    AVChannelLayout layout;
+    SwrContext *swr = NULL;
+    const int nb_frames = in_rate * seconds / FRAME_SIZE;
+    const int bps = av_get_bytes_per_sample(fmt);
+    int max_out;
+    uint8_t **out;
+    int64_t start;
+    int ret, pos = 0;
+
+    av_channel_layout_default(&layout, channels);
+    ret = swr_alloc_set_opts2(&swr, &layout, fmt, out_rate,
+                              &layout, fmt, in_rate, 0, NULL);
+    if (ret < 0)
+        return ret;
+    av_opt_set_int(swr, "threads", threads, 0);
+    if ((ret = swr_init(swr)) < 0)
+        goto end;
+
+    max_out = av_rescale_rnd(nb_frames * FRAME_SIZE, out_rate, in_rate, AV_ROUND_UP) + 256;
+    ret = av_samples_alloc_array_and_samples(&out, NULL, channels, max_out, fmt, 0);
+    if (ret < 0)
+        goto end;
+
+    start = av_gettime_relative();
+    for (int i = 0; i <= nb_frames; i++) {
+        const uint8_t *src[64];
+        uint8_t *dst[64];
+
+        for (int ch = 0; ch < channels; ch++) {
+            src[ch] = in[ch]  + (size_t)i * FRAME_SIZE * bps;
+            dst[ch] = out[ch] + (size_t)pos * bps;
+        }
+        ret = swr_convert(swr, dst, max_out - pos,
+                          i < nb_frames ? src : NULL, i < nb_frames ? FRAME_SIZE : 0);
+        if (ret < 0) {
+            av_freep(&out[0]);
+            av_freep(&out);
+            goto end;
+        }
+        pos += ret;
+    }
+    *time     = av_gettime_relative() - start;
+    *pout     = out;
+    *out_size = pos;
+    ret = 0;
+
+end:
+    swr_free(&swr);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    int in_rate  = argc > 1 ? atoi(argv[1]) : 48000;
+    int out_rate = argc > 2 ? atoi(argv[2]) : 44100;
+    int channels = argc > 3 ? atoi(argv[3]) : 8;
+    int threads  = argc > 4 ? atoi(argv[4]) : 4;
+    int seconds  = argc > 5 ? atoi(argv[5]) : 1;
+    enum AVSampleFormat fmts[] = { AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S32P,
+                                   AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_DBLP };
+    int nb_fmts = FF_ARRAY_ELEMS(fmts);
+    AVLFG lfg;
+    int ret = 0;
+
+    if (argc > 6) {
+        fmts[0] = av_get_sample_fmt(argv[6]);
+        nb_fmts = 1;
+        if (!av_sample_fmt_is_planar(fmts[0])) {
+            fprintf(stderr, "planar sample format expected\n");
+            return 1;
+        }
+    }
+    if (in_rate <= 0 || out_rate <= 0 || channels <= 0 || channels > 64 ||
+        threads < 0 || seconds <= 0) {
+        fprintf(stderr, "invalid arguments\n");
+        return 1;
+    }
+
+    av_lfg_init(&lfg, 0xdeadbeef);
+
+    for (int f = 0; f < nb_fmts && !ret; f++) {
+        const enum AVSampleFormat fmt = fmts[f];
+        const int nb_samples = (in_rate * seconds / FRAME_SIZE) * FRAME_SIZE;
+        uint8_t **in, **ref = NULL, **new = NULL;
+        int ref_size, new_size;
+        int64_t ref_time, new_time;
+
+        ret = av_samples_alloc_array_and_samples(&in, NULL, channels, nb_samples, fmt, 0);
+        if (ret < 0)
+            return 1;
+        for (int ch = 0; ch < channels; ch++) {
+            for (int i = 0; i < nb_samples; i++) {
+                const double v = (int32_t)av_lfg_get(&lfg) / 4294967296.0;
+                switch (fmt) {
+                case AV_SAMPLE_FMT_S16P: ((int16_t *)in[ch])[i] = v * 32767;      break;
+                case AV_SAMPLE_FMT_S32P: ((int32_t *)in[ch])[i] = v * 2147483647; break;
+                case AV_SAMPLE_FMT_FLTP: ((float   *)in[ch])[i] = v;              break;
+                case AV_SAMPLE_FMT_DBLP: ((double  *)in[ch])[i] = v;              break;
+                default: break;
+                }
+            }
+        }
+
+        ret = run(fmt, in_rate, out_rate, channels, 1, seconds, in, &ref, &ref_size, &ref_time);
+        if (ret >= 0)
+            ret = run(fmt, in_rate, out_rate, channels, threads, seconds, in, &new, &new_size, &new_time);
+        if (ret < 0) {
+            fprintf(stderr, "%s: resampling failed\n", av_get_sample_fmt_name(fmt));
+            ret = 1;
+        } else {
+            const int bps = av_get_bytes_per_sample(fmt);
+            ret = ref_size != new_size;
+            for (int ch = 0; ch < channels && !ret; ch++)
+                ret = memcmp(ref[ch], new[ch], (size_t)ref_size * bps) != 0;
+            printf("%s %d->%d Hz, %d channels: 1 thread %"PRId64" us, %d threads %"PRId64" us%s\n",
+                   av_get_sample_fmt_name(fmt), in_rate, out_rate, channels,
+                   ref_time, threads, new_time, ret ? ", output mismatch" : "");
+        }
+
+        av_freep(&in[0]);
+        av_freep(&in);
+        if (ref)
+            av_freep(&ref[0]);
+        av_freep(&ref);
+        if (new)
+            av_freep(&new[0]);
+        av_freep(&new);
+    }
+
+    return ret;
+}
@@ -608,6 +608,107 @@ pack_8ch_%2_to_%1_u_int %+ SUFFIX:
 %macro NOP_N 0-6
 %endmacro
 
+; dst, src and noise point to arrays of pointers, len is a multiple of 16,
+; no alignment is required. noise is added to src before the conversion.
+
+;to
+%macro CONV_DITHER 1
+cglobal float_to_%1_dither, 4, 4, 6, dst, src, noise, len
+    mov       dstq, [dstq]
+    mov       srcq, [srcq]
+    mov     noiseq, [noiseq]
+    movsxdifnidn lenq, lend
+    lea       srcq, [srcq   + 4*lenq]
+    lea     noiseq, [noiseq + 4*lenq]
+%ifidn %1, int16
+    lea       dstq, [dstq   + 2*lenq]
+    mova        m5, [flt2p15]
+%else
+    lea       dstq, [dstq   + 4*lenq]
+    mova        m5, [flt2p31]
+%endif
+    neg       lenq
+.next:
+    movu        m0, [srcq   + 4*lenq]
+    movu        m1, [srcq   + 4*lenq + mmsize]
+    movu        m2, [noiseq + 4*lenq]
+    movu        m3, [noiseq + 4*lenq + mmsize]
+    addps       m0, m2
+    addps       m1, m3
+%ifidn %1, int16
+    mulps       m0, m5
+    mulps       m1, m5
+    cvtps2dq    m0, m0
+    cvtps2dq    m1, m1
+    packssdw    m0, m1
+%if cpuflag(avx2)
+    vpermq      m0, m0, q3120
+%endif
+    movu [dstq + 2*lenq], m0
+%else
+    FLOAT_TO_INT32_N m0, m1, m2, m3, m5, m4
+    movu [dstq + 4*lenq], m0
+    movu [dstq + 4*lenq + mmsize], m1
+%endif
+    add       lenq, mmsize/2
+        jl .next
+    RET
+%endmacro
+
+;to
+%macro PACK_2CH_DITHER 1
+cglobal pack_2ch_float_to_%1_dither, 4, 6, 6, dst, src, noise, len, src2, noise2
+    mov      src2q, [srcq   + gprsize]
+    mov       srcq, [srcq]
+    mov    noise2q, [noiseq + gprsize]
+    mov     noiseq, [noiseq]
+    mov       dstq, [dstq]
+    movsxdifnidn lenq, lend
+    lea       srcq, [srcq   + 4*lenq]
+    lea      src2q, [src2q  + 4*lenq]
+    lea     noiseq, [noiseq + 4*lenq]
+    lea    noise2q, [noise2q+ 4*lenq]
+%ifidn %1, int16
+    lea       dstq, [dstq   + 4*lenq]
+    mova        m5, [flt2p15]
+%else
+    lea       dstq, [dstq   + 8*lenq]
+    mova        m5, [flt2p31]
+%endif
+    neg       lenq
+.next:
+    movu        m0, [srcq   + 4*lenq]
+    movu        m1, [src2q  + 4*lenq]
+    movu        m2, [noiseq + 4*lenq]
+    movu        m3, [noise2q+ 4*lenq]
+    addps       m0, m2
+    addps       m1, m3
+%ifidn %1, int16
+    mulps       m0, m5
+    mulps       m1, m5
+    cvtps2dq    m0, m0
+    cvtps2dq    m1, m1
+    punpckhdq   m2, m0, m1
+    punpckldq   m0, m1
+    packssdw    m0, m2
+    movu [dstq + 4*lenq], m0
+%else
+    FLOAT_TO_INT32_N m0, m1, m2, m3, m5, m4
+    punpckhdq   m2, m0, m1
+    punpckldq   m0, m1
+%if cpuflag(avx2)
+    vperm2i128  m1, m0, m2, 0x31
+    vinserti128 m0, m0, xm2, 1
+    SWAP 1, 2
+%endif
+    movu [dstq + 8*lenq], m0
+    movu [dstq + 8*lenq + mmsize], m2
+%endif
+    add       lenq, mmsize/4
+        jl .next
+    RET
+%endmacro
+
 INIT_XMM sse
 PACK_6CH float, float, u, 2, 2, 7, NOP_N, NOP_N
 PACK_6CH float, float, a, 2, 2, 7, NOP_N, NOP_N
@@ -684,6 +785,11 @@ PACK_8CH float, int32, a, 2, 2, 10, INT32_TO_FLOAT_N, INT32_TO_FLOAT_INIT
 PACK_8CH int32, float, u, 2, 2, 10, FLOAT_TO_INT32_N, FLOAT_TO_INT32_INIT
 PACK_8CH int32, float, a, 2, 2, 10, FLOAT_TO_INT32_N, FLOAT_TO_INT32_INIT
 
+CONV_DITHER int16
+CONV_DITHER int32
+PACK_2CH_DITHER int16
+PACK_2CH_DITHER int32
+
 INIT_XMM ssse3
 UNPACK_2CH int16, int16, u, 1, 1, NOP_N, NOP_N
 UNPACK_2CH int16, int16, a, 1, 1, NOP_N, NOP_N
@@ -727,4 +833,9 @@ CONV float, int32, a, 2, 2, INT32_TO_FLOAT_N, INT32_TO_FLOAT_INIT
 INIT_YMM avx2
 CONV int32, float, u, 2, 2, FLOAT_TO_INT32_N, FLOAT_TO_INT32_INIT
 CONV int32, float, a, 2, 2, FLOAT_TO_INT32_N, FLOAT_TO_INT32_INIT
+
+CONV_DITHER int16
+CONV_DITHER int32
+PACK_2CH_DITHER int16
+PACK_2CH_DITHER int32
 %endif
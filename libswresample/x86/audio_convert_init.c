@@ -34,6 +34,16 @@ PROTO4(_pack_8ch_)
 PROTO4(_unpack_2ch_)
 PROTO4(_unpack_6ch_)
 
+#define DITHER_PROTO(pre, out, cap) void ff ## pre ## float_to_ ## out ## _dither_ ## cap(uint8_t **dst, const uint8_t **src, const uint8_t **noise, int len);
+DITHER_PROTO(_, int16, sse2)
+DITHER_PROTO(_, int32, sse2)
+DITHER_PROTO(_pack_2ch_, int16, sse2)
+DITHER_PROTO(_pack_2ch_, int32, sse2)
+DITHER_PROTO(_, int16, avx2)
+DITHER_PROTO(_, int32, avx2)
+DITHER_PROTO(_pack_2ch_, int16, avx2)
+DITHER_PROTO(_pack_2ch_, int32, avx2)
+
 av_cold void swri_audio_convert_init_x86(struct AudioConvert *ac,
                                  enum AVSampleFormat out_fmt,
                                  enum AVSampleFormat in_fmt,
@@ -41,6 +51,7 @@ av_cold void swri_audio_convert_init_x86(struct AudioConvert *ac,
     int mm_flags = av_get_cpu_flags();
 
     ac->simd_f= NULL;
+    ac->simd_dither_f = NULL;
 
 //FIXME add memcpy case
 
@@ -172,4 +183,22 @@ MULTI_CAPS_FUNC(SSE2, sse2)
         if(   out_fmt == AV_SAMPLE_FMT_S32  && in_fmt == AV_SAMPLE_FMT_FLT || out_fmt == AV_SAMPLE_FMT_S32P && in_fmt == AV_SAMPLE_FMT_FLTP)
             ac->simd_f =  ff_float_to_int32_a_avx2;
     }
+
+    if (ac->dither_f) {
+#define DITHER_FUNCS(cap) \
+        if (out_fmt == AV_SAMPLE_FMT_S16P) \
+            ac->simd_dither_f = ff_float_to_int16_dither_ ## cap; \
+        if (out_fmt == AV_SAMPLE_FMT_S32P) \
+            ac->simd_dither_f = ff_float_to_int32_dither_ ## cap; \
+        if (out_fmt == AV_SAMPLE_FMT_S16 && channels == 2) \
+            ac->simd_dither_f = ff_pack_2ch_float_to_int16_dither_ ## cap; \
+        if (out_fmt == AV_SAMPLE_FMT_S32 && channels == 2) \
+            ac->simd_dither_f = ff_pack_2ch_float_to_int32_dither_ ## cap;
+        if (EXTERNAL_SSE2(mm_flags)) {
+            DITHER_FUNCS(sse2)
+        }
+        if (EXTERNAL_AVX2_FAST(mm_flags)) {
+            DITHER_FUNCS(avx2)
+        }
+    }
 }
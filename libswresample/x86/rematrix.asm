@@ -23,6 +23,7 @@
 
 SECTION_RODATA 32
 dw1: times 8  dd 1
+dq16384: times 4 dq 16384
 w1 : times 16 dw 1
 
 SECTION .text
@@ -222,6 +223,121 @@ mix_2_1_int16_u_int %+ SUFFIX:
 %endif
 %endmacro
 
+;-----------------------------------------------------------------------------
+; void mix_n_1(void *out, const void **in, void *coeffp, integer nb, integer len)
+;
+; out[i] = sum(coeffp[j] * in[j][i]) over the nb inputs, len must be a multiple
+; of 2 * mmsize bytes of output for float and mmsize bytes for int16 and int32.
+; For int16, coeffp starts with the shift followed by pairs of 16-bit
+; coefficients, and nb must be even.
+; For int32, the coefficients are 32-bit Q15 and the sums are 64-bit, as in
+; the C loop.
+;-----------------------------------------------------------------------------
+
+%if ARCH_X86_64
+%macro MIXN_FLT 0
+cglobal mix_n_1_float, 5, 8, 5, out, in, coeffp, nb, len, i, j, src
+    shl        lenq, 2
+    xor          iq, iq
+.next:
+    xorps        m0, m0
+    xorps        m1, m1
+    xor          jq, jq
+.channel:
+    mov        srcq, [inq + jq*gprsize]
+    VBROADCASTSS m2, [coeffpq + 4*jq]
+    movu         m3, [srcq + iq         ]
+    movu         m4, [srcq + iq + mmsize]
+    mulps        m3, m2
+    mulps        m4, m2
+    addps        m0, m3
+    addps        m1, m4
+    inc          jq
+    cmp          jq, nbq
+        jl .channel
+    movu  [outq + iq         ], m0
+    movu  [outq + iq + mmsize], m1
+    add          iq, mmsize*2
+    cmp          iq, lenq
+        jl .next
+    RET
+%endmacro
+
+%macro MIXN_INT16 0
+cglobal mix_n_1_int16, 5, 8, 8, out, in, coeffp, nb, len, i, j, src
+    movd        xm6, [coeffpq]
+    mova         m7, [dw1]
+    pslld        m7, xm6
+    psrld        m7, 1
+    add     coeffpq, 4
+    add        lenq, lenq
+    xor          iq, iq
+.next:
+    pxor         m0, m0
+    pxor         m1, m1
+    xor          jq, jq
+.pair:
+    mov        srcq, [inq + jq*gprsize]
+    movu         m2, [srcq + iq]
+    mov        srcq, [inq + jq*gprsize + gprsize]
+    movu         m4, [srcq + iq]
+    VPBROADCASTD m5, [coeffpq + 2*jq]
+    punpckhwd    m3, m2, m4
+    punpcklwd    m2, m4
+    pmaddwd      m2, m5
+    pmaddwd      m3, m5
+    paddd        m0, m2
+    paddd        m1, m3
+    add          jq, 2
+    cmp          jq, nbq
+        jl .pair
+    paddd        m0, m7
+    paddd        m1, m7
+    psrad        m0, xm6
+    psrad        m1, xm6
+    packssdw     m0, m1
+    movu  [outq + iq], m0
+    add          iq, mmsize
+    cmp          iq, lenq
+        jl .next
+    RET
+%endmacro
+
+%macro MIXN_INT32 0
+cglobal mix_n_1_int32, 5, 8, 6, out, in, coeffp, nb, len, i, j, src
+    mova         m5, [dq16384]
+    shl        lenq, 2
+    xor          iq, iq
+.next:
+    pxor         m0, m0                 ; even samples
+    pxor         m1, m1                 ; odd samples
+    xor          jq, jq
+.channel:
+    mov        srcq, [inq + jq*gprsize]
+    VPBROADCASTD m4, [coeffpq + 4*jq]
+    movu         m2, [srcq + iq]
+    psrlq        m3, m2, 32
+    pmuldq       m2, m4
+    pmuldq       m3, m4
+    paddq        m0, m2
+    paddq        m1, m3
+    inc          jq
+    cmp          jq, nbq
+        jl .channel
+    ; the low 32 bits of (v + 16384) >> 15 do not depend on the sign fill
+    paddq        m0, m5
+    paddq        m1, m5
+    psrlq        m0, 15
+    psrlq        m1, 15
+    psllq        m1, 32
+    pblendw      m0, m1, 0xCC
+    movu  [outq + iq], m0
+    add          iq, mmsize
+    cmp          iq, lenq
+        jl .next
+    RET
+%endmacro
+%endif
 
 INIT_XMM sse
 MIX2_FLT u
@@ -242,3 +358,21 @@ MIX2_FLT a
 MIX1_FLT u
 MIX1_FLT a
 %endif
+
+%if ARCH_X86_64
+INIT_XMM sse
+MIXN_FLT
+INIT_XMM sse2
+MIXN_INT16
+INIT_XMM sse4
+MIXN_INT32
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+MIXN_FLT
+%endif
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+MIXN_INT16
+MIXN_INT32
+%endif
+%endif
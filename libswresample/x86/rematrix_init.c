@@ -30,6 +30,13 @@ D(float, sse)
 D(float, avx)
 D(int16, sse2)
 
+mix_n_1_func_type ff_mix_n_1_float_sse;
+mix_n_1_func_type ff_mix_n_1_float_avx;
+mix_n_1_func_type ff_mix_n_1_int16_sse2;
+mix_n_1_func_type ff_mix_n_1_int16_avx2;
+mix_n_1_func_type ff_mix_n_1_int32_sse4;
+mix_n_1_func_type ff_mix_n_1_int32_avx2;
+
 av_cold int swri_rematrix_init_x86(struct SwrContext *s){
 #if HAVE_X86ASM
     int mm_flags = av_get_cpu_flags();
@@ -40,12 +47,20 @@ av_cold int swri_rematrix_init_x86(struct SwrContext *s){
 
     s->mix_1_1_simd = NULL;
     s->mix_2_1_simd = NULL;
+    s->mix_n_1_simd = NULL;
 
     if (s->midbuf.fmt == AV_SAMPLE_FMT_S16P){
         if(EXTERNAL_SSE2(mm_flags)) {
             s->mix_1_1_simd = ff_mix_1_1_a_int16_sse2;
             s->mix_2_1_simd = ff_mix_2_1_a_int16_sse2;
+#if ARCH_X86_64
+            s->mix_n_1_simd = ff_mix_n_1_int16_sse2;
+#endif
         }
+#if ARCH_X86_64
+        if(EXTERNAL_AVX2_FAST(mm_flags) && s->mix_n_1_simd)
+            s->mix_n_1_simd = ff_mix_n_1_int16_avx2;
+#endif
         s->native_simd_matrix = av_calloc(num,  2 * sizeof(int16_t));
         s->native_simd_one    = av_mallocz(2 * sizeof(int16_t));
         if (!s->native_simd_matrix || !s->native_simd_one)
@@ -64,6 +79,22 @@ av_cold int swri_rematrix_init_x86(struct SwrContext *s){
         }
         ((int16_t*)s->native_simd_one)[1] = 14;
         ((int16_t*)s->native_simd_one)[0] = 16384;
+
+        if (s->mix_n_1_simd) {
+            s->native_simd_n_matrix = av_calloc(nb_out, (SWR_CH_MAX + 1) * sizeof(int32_t));
+            if (!s->native_simd_n_matrix)
+                return AVERROR(ENOMEM);
+            /* shift, then the coefficients of the used inputs in pairs */
+            for(i=0; i<nb_out; i++){
+                int16_t *row = (int16_t*)s->native_simd_n_matrix + i * 2 * (SWR_CH_MAX + 1);
+                int nb = s->matrix_ch[i][0];
+                if (nb < 1)
+                    continue;
+                ((int32_t*)row)[0] = ((int16_t*)s->native_simd_matrix)[2*(i * nb_in + s->matrix_ch[i][1])+1];
+                for(j=0; j<nb; j++)
+                    row[2 + j] = ((int16_t*)s->native_simd_matrix)[2*(i * nb_in + s->matrix_ch[i][1+j])];
+            }
+        }
     } else if(s->midbuf.fmt == AV_SAMPLE_FMT_FLTP){
         if(EXTERNAL_SSE(mm_flags)) {
             s->mix_1_1_simd = ff_mix_1_1_a_float_sse;
@@ -73,13 +104,52 @@ av_cold int swri_rematrix_init_x86(struct SwrContext *s){
             s->mix_1_1_simd = ff_mix_1_1_a_float_avx;
             s->mix_2_1_simd = ff_mix_2_1_a_float_avx;
         }
+#if ARCH_X86_64
+        if(EXTERNAL_SSE(mm_flags))
+            s->mix_n_1_simd = ff_mix_n_1_float_sse;
+        if(EXTERNAL_AVX_FAST(mm_flags))
+            s->mix_n_1_simd = ff_mix_n_1_float_avx;
+#endif
         s->native_simd_matrix = av_calloc(num, sizeof(float));
         s->native_simd_one = av_mallocz(sizeof(float));
         if (!s->native_simd_matrix || !s->native_simd_one)
             return AVERROR(ENOMEM);
         memcpy(s->native_simd_matrix, s->native_matrix, num * sizeof(float));
         memcpy(s->native_simd_one, s->native_one, sizeof(float));
+
+        if (s->mix_n_1_simd) {
+            s->native_simd_n_matrix = av_calloc(nb_out, (SWR_CH_MAX + 1) * sizeof(float));
+            if (!s->native_simd_n_matrix)
+                return AVERROR(ENOMEM);
+            for(i=0; i<nb_out; i++){
+                float *row = (float*)s->native_simd_n_matrix + i * (SWR_CH_MAX + 1);
+                for(j=0; j<s->matrix_ch[i][0]; j++)
+                    row[j] = s->matrix_flt[i][s->matrix_ch[i][1+j]];
+            }
+        }
+    } else if(s->midbuf.fmt == AV_SAMPLE_FMT_S32P){
+#if ARCH_X86_64
+        if(EXTERNAL_SSE4(mm_flags))
+            s->mix_n_1_simd = ff_mix_n_1_int32_sse4;
+        if(EXTERNAL_AVX2_FAST(mm_flags))
+            s->mix_n_1_simd = ff_mix_n_1_int32_avx2;
+#endif
+        if (s->mix_n_1_simd) {
+            s->native_simd_n_matrix = av_calloc(nb_out, (SWR_CH_MAX + 1) * sizeof(int32_t));
+            if (!s->native_simd_n_matrix)
+                return AVERROR(ENOMEM);
+            for(i=0; i<nb_out; i++){
+                int32_t *row = (int32_t*)s->native_simd_n_matrix + i * (SWR_CH_MAX + 1);
+                for(j=0; j<s->matrix_ch[i][0]; j++)
+                    row[j] = s->matrix32[i][s->matrix_ch[i][1+j]];
+            }
+        }
     }
+
+    /* mix6to2 and mix8to2 are scalar, the channels of the default 5.1 and
+     * 7.1 downmixes are better served by mix_n_1_simd */
+    if (s->mix_n_1_simd)
+        s->mix_any_f = NULL;
 #endif
 
     return 0;
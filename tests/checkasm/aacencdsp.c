@@ -60,6 +60,71 @@ static void test_abs_pow34(AACEncDSPContext *s)
     report("abs_pow34");
 }
 
+static void test_quant_bands(AACEncDSPContext *s)
+{
+    /* not a multiple of 8 so that the tail of the ymm versions is tested */
+    const int size = BUF_SIZE - 4;
+    LOCAL_ALIGNED_32(float, in, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, scaled, [BUF_SIZE]);
+    static const int maxvals[] = { 1, 2, 4, 7, 12, 16, 8191 };
+
+    declare_func(void, int *, const float *, const float *, int, int, int,
+                 const float, const float);
+
+    randomize_float(in, BUF_SIZE);
+    for (int i = 0; i < BUF_SIZE; i++)
+        scaled[i] = fabsf(in[i]);
+
+    for (int is_signed = 0; is_signed <= 1; is_signed++) {
+        const int maxval = maxvals[rnd() % FF_ARRAY_ELEMS(maxvals)];
+        const float q34 = (float)rnd() / UINT_MAX * 4.0f;
+        const float rounding = is_signed ? 0.4054f : 0.1215f;
+
+        if (check_func(s->quant_bands, "quant_bands_%ssigned", is_signed ? "" : "un")) {
+            LOCAL_ALIGNED_32(int, out, [BUF_SIZE]);
+            LOCAL_ALIGNED_32(int, out2, [BUF_SIZE]);
+
+            call_ref(out, in, scaled, size, is_signed, maxval, q34, rounding);
+            call_new(out2, in, scaled, size, is_signed, maxval, q34, rounding);
+
+            if (memcmp(out, out2, size * sizeof(*out)))
+                fail();
+
+            bench_new(out, in, scaled, size, is_signed, maxval, q34, rounding);
+        }
+    }
+
+    report("quant_bands");
+}
+
+static void test_band_energy(AACEncDSPContext *s)
+{
+    static const int sizes[] = { 4, 12, 32, 96, BUF_SIZE };
+    LOCAL_ALIGNED_32(float, in, [BUF_SIZE]);
+
+    declare_func(void, float *, float *, const float *, int);
+
+    randomize_float(in, BUF_SIZE);
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(sizes); i++) {
+        if (check_func(s->band_energy, "band_energy_%d", sizes[i])) {
+            float energy, energy2, form_factor, form_factor2;
+
+            call_ref(&energy,  &form_factor,  in, sizes[i]);
+            call_new(&energy2, &form_factor2, in, sizes[i]);
+
+            /* the SIMD versions sum in a different order */
+            if (!float_near_abs_eps(energy, energy2, energy * 1e-5f) ||
+                !float_near_abs_eps(form_factor, form_factor2, form_factor * 1e-5f))
+                fail();
+
+            bench_new(&energy, &form_factor, in, sizes[i]);
+        }
+    }
+
+    report("band_energy");
+}
+
 
 void checkasm_check_aacencdsp(void)
 {
@@ -67,4 +132,6 @@ void checkasm_check_aacencdsp(void)
     ff_aacenc_dsp_init(&s);
 
     test_abs_pow34(&s);
+    test_quant_bands(&s);
+    test_band_energy(&s);
 }
@@ -0,0 +1,157 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "libavfilter/af_loudnormdsp.h"
+#include "libavutil/macros.h"
+#include "libavutil/mem_internal.h"
+#include "checkasm.h"
+
+/* a multiple of every channel_align, two groups for the widest version */
+#define CHANNELS 16
+#define LEN      240
+#define BUF_SIZE (CHANNELS * LEN)
+
+static void randomize_float(float *buf, int size)
+{
+    for (int i = 0; i < size; i++)
+        buf[i] = (float)rnd() / (UINT_MAX >> 1) - 1.0f;
+}
+
+static void test_kweight(LoudNormDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(float, src, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, dst_ref, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, dst_new, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, state_ref, [4 * CHANNELS]);
+    LOCAL_ALIGNED_32(float, state_new, [4 * CHANNELS]);
+    /* K-weighting coefficients at 48 kHz */
+    static const float kcoeffs[LOUDNORM_KWEIGHT_COEFFS] = {
+        1.53512485958697f, -2.69169618940638f, 1.19839281085285f,
+        -1.69065929318241f, 0.73248077421585f,
+        1.0f, -2.0f, 1.0f,
+        -1.99004745483398f, 0.99007225036621f,
+    };
+    LOCAL_ALIGNED_32(float, coeffs, [LOUDNORM_KWEIGHT_COEFFS * LOUDNORM_KWEIGHT_WIDTH]);
+
+    declare_func(void, float *dst, const float *src, float *state,
+                 const float *coeffs, ptrdiff_t channels, ptrdiff_t len);
+
+    for (int i = 0; i < LOUDNORM_KWEIGHT_COEFFS * LOUDNORM_KWEIGHT_WIDTH; i++)
+        coeffs[i] = kcoeffs[i / LOUDNORM_KWEIGHT_WIDTH];
+
+    if (check_func(dsp->kweight, "kweight")) {
+        randomize_float(src, BUF_SIZE);
+        randomize_float(state_ref, 4 * CHANNELS);
+        memcpy(state_new, state_ref, 4 * CHANNELS * sizeof(*state_ref));
+
+        call_ref(dst_ref, src, state_ref, coeffs, CHANNELS, LEN);
+        call_new(dst_new, src, state_new, coeffs, CHANNELS, LEN);
+        if (!float_near_abs_eps_array(dst_ref, dst_new, 1e-4f, BUF_SIZE) ||
+            !float_near_abs_eps_array(state_ref, state_new, 1e-4f, 4 * CHANNELS))
+            fail();
+        bench_new(dst_new, src, state_new, coeffs, CHANNELS, LEN);
+    }
+}
+
+static void test_energy(LoudNormDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(float, src, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(double, sum_ref, [CHANNELS]);
+    LOCAL_ALIGNED_32(double, sum_new, [CHANNELS]);
+
+    declare_func(void, double *sum, const float *src, ptrdiff_t channels,
+                 ptrdiff_t len);
+
+    if (check_func(dsp->energy, "energy")) {
+        randomize_float(src, BUF_SIZE);
+        for (int i = 0; i < CHANNELS; i++)
+            sum_ref[i] = sum_new[i] = i;
+
+        call_ref(sum_ref, src, CHANNELS, LEN);
+        call_new(sum_new, src, CHANNELS, LEN);
+        if (!double_near_abs_eps_array(sum_ref, sum_new, 1e-9, CHANNELS))
+            fail();
+        bench_new(sum_new, src, CHANNELS, LEN);
+    }
+}
+
+static void test_peak(LoudNormDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(float, src, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, peak_ref, [CHANNELS]);
+    LOCAL_ALIGNED_32(float, peak_new, [CHANNELS]);
+
+    declare_func(void, float *peak, const float *src, ptrdiff_t channels,
+                 ptrdiff_t len);
+
+    if (check_func(dsp->peak, "peak")) {
+        randomize_float(src, BUF_SIZE);
+        for (int i = 0; i < CHANNELS; i++)
+            peak_ref[i] = peak_new[i] = i & 1 ? 2.0f : 0.0f;
+
+        call_ref(peak_ref, src, CHANNELS, LEN);
+        call_new(peak_new, src, CHANNELS, LEN);
+        if (memcmp(peak_ref, peak_new, CHANNELS * sizeof(*peak_ref)))
+            fail();
+        bench_new(peak_new, src, CHANNELS, LEN);
+    }
+}
+
+static void test_max_abs(LoudNormDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(double, src, [BUF_SIZE]);
+    static const int lens[] = { 0, 1, 2, 3, 5, 6, 7, BUF_SIZE - 1, BUF_SIZE };
+
+    declare_func_float(double, const double *src, ptrdiff_t len);
+
+    if (check_func(dsp->max_abs, "max_abs")) {
+        for (int i = 0; i < BUF_SIZE; i++)
+            src[i] = (double)rnd() / (UINT_MAX >> 1) - 1.0;
+
+        /* odd lengths exercise the scalar tail */
+        for (int i = 0; i < FF_ARRAY_ELEMS(lens); i++) {
+            double ref, new;
+
+            ref = call_ref(src, lens[i]);
+            new = call_new(src, lens[i]);
+            if (ref != new)
+                fail();
+        }
+        bench_new(src, BUF_SIZE);
+    }
+}
+
+void checkasm_check_loudnorm(void)
+{
+    LoudNormDSPContext dsp;
+
+    ff_loudnorm_init(&dsp);
+
+    test_kweight(&dsp);
+    report("kweight");
+    test_energy(&dsp);
+    report("energy");
+    test_peak(&dsp);
+    report("peak");
+    test_max_abs(&dsp);
+    report("max_abs");
+}
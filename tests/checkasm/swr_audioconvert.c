@@ -0,0 +1,125 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "libavutil/mem_internal.h"
+#include "libavutil/samplefmt.h"
+
+#include "libswresample/audioconvert.h"
+#include "libswresample/swresample_internal.h"
+
+#include "checkasm.h"
+
+#define LEN 64
+#define CHANNELS 2
+
+static void check_dither(enum AVSampleFormat out_fmt, const char *name)
+{
+    LOCAL_ALIGNED_32(float, src,   [CHANNELS], [LEN]);
+    LOCAL_ALIGNED_32(float, noise, [CHANNELS], [LEN]);
+    LOCAL_ALIGNED_32(float, noisy, [CHANNELS], [LEN]);
+    LOCAL_ALIGNED_32(uint8_t, dst_fused,    [CHANNELS * LEN * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst_two_pass, [CHANNELS * LEN * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst_new,      [CHANNELS * LEN * 4]);
+    const int planar = av_sample_fmt_is_planar(out_fmt);
+    const int bps    = av_get_bytes_per_sample(out_fmt);
+    const int os     = (planar ? 1 : CHANNELS) * bps;
+    const uint8_t *srcp[CHANNELS], *noisep[CHANNELS];
+    uint8_t *dst[CHANNELS];
+    AudioData in  = { .ch_count = CHANNELS, .bps = 4,   .planar = 1,      .fmt = AV_SAMPLE_FMT_FLTP };
+    AudioData out = { .ch_count = CHANNELS, .bps = bps, .planar = planar, .fmt = out_fmt };
+    AudioConvert *ac, *conv;
+
+    declare_func(void, uint8_t **dst, const uint8_t **src,
+                 const uint8_t **noise, int len);
+
+    ac   = swri_audio_convert_alloc(out_fmt, AV_SAMPLE_FMT_FLTP, CHANNELS, NULL, 0);
+    conv = swri_audio_convert_alloc(out_fmt, AV_SAMPLE_FMT_FLTP, CHANNELS, NULL, 0);
+    if (!ac || !conv || !ac->dither_f) {
+        fail();
+        goto end;
+    }
+
+    if (check_func(ac->simd_dither_f, "%s_dither", name)) {
+        for (int ch = 0; ch < CHANNELS; ch++) {
+            for (int i = 0; i < LEN; i++) {
+                src[ch][i]   = (int)(rnd() & 0xFFFF) / 32768.0f - 1.0f;
+                noise[ch][i] = ((int)(rnd() % 129) - 64) / 32768.0f;
+            }
+            /* saturation on both sides */
+            src[ch][0]   =  1.0f;
+            noise[ch][0] =  2.0f / 32768.0f;
+            src[ch][1]   = -1.0f;
+            noise[ch][1] = -2.0f / 32768.0f;
+            srcp[ch]   = (const uint8_t *)src[ch];
+            noisep[ch] = (const uint8_t *)noise[ch];
+        }
+
+        /* the C fused path */
+        memset(dst_fused, 0, CHANNELS * LEN * bps);
+        for (int ch = 0; ch < CHANNELS; ch++) {
+            uint8_t *po = dst_fused + ch * (planar ? LEN * bps : bps);
+            ac->dither_f(po, srcp[ch], noise[ch], os, po + os * LEN);
+        }
+
+        /* the two pass path: noise added to the input, then the C conversion */
+        memset(dst_two_pass, 0, CHANNELS * LEN * bps);
+        conv->simd_f = NULL;
+        for (int ch = 0; ch < CHANNELS; ch++) {
+            for (int i = 0; i < LEN; i++)
+                noisy[ch][i] = src[ch][i] + noise[ch][i];
+            in.ch[ch]  = (uint8_t *)noisy[ch];
+            out.ch[ch] = dst_two_pass + ch * (planar ? LEN * bps : bps);
+        }
+        swri_audio_convert(conv, &out, &in, LEN);
+
+        memset(dst_new, 0, CHANNELS * LEN * bps);
+        for (int ch = 0; ch < CHANNELS; ch++)
+            dst[ch] = dst_new + ch * (planar ? LEN * bps : bps);
+        if (planar) {
+            for (int ch = 0; ch < CHANNELS; ch++) {
+                call_new(dst + ch, srcp + ch, noisep + ch, LEN);
+            }
+        } else {
+            call_new(dst, srcp, noisep, LEN);
+        }
+
+        if (memcmp(dst_fused, dst_new, CHANNELS * LEN * bps) ||
+            memcmp(dst_two_pass, dst_new, CHANNELS * LEN * bps))
+            fail();
+
+        bench_new(dst, srcp, noisep, LEN);
+    }
+
+end:
+    swri_audio_convert_free(&ac);
+    swri_audio_convert_free(&conv);
+}
+
+void checkasm_check_swr_audioconvert(void)
+{
+    check_dither(AV_SAMPLE_FMT_S16P, "float_to_int16");
+    check_dither(AV_SAMPLE_FMT_S32P, "float_to_int32");
+    report("dither");
+
+    check_dither(AV_SAMPLE_FMT_S16, "pack_2ch_float_to_int16");
+    check_dither(AV_SAMPLE_FMT_S32, "pack_2ch_float_to_int32");
+    report("pack_2ch_dither");
+}
@@ -0,0 +1,177 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <float.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libavutil/channel_layout.h"
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+#include "libavutil/opt.h"
+
+#include "libswresample/swresample.h"
+#include "libswresample/swresample_internal.h"
+
+#include "checkasm.h"
+
+#define LEN 64
+#define MIN_INPUTS 3
+#define MAX_INPUTS 8
+
+static SwrContext *alloc_rematrix(enum AVSampleFormat fmt, int nb_in,
+                                  const double *matrix)
+{
+    AVChannelLayout in_layout, out_layout = (AVChannelLayout)AV_CHANNEL_LAYOUT_MONO;
+    SwrContext *s = NULL;
+
+    av_channel_layout_default(&in_layout, nb_in);
+    if (swr_alloc_set_opts2(&s, &out_layout, fmt, 48000,
+                            &in_layout, fmt, 48000, 0, NULL) < 0)
+        return NULL;
+    av_opt_set_sample_fmt(s, "internal_sample_fmt", fmt, 0);
+    if (swr_set_matrix(s, matrix, nb_in) < 0 || swr_init(s) < 0)
+        swr_free(&s);
+    return s;
+}
+
+/* the C rematrix loop, in the order the SIMD version accumulates */
+static void mix_n_1_float_ref(float *out, const float **in, const float *coeff,
+                              int nb, int len)
+{
+    for (int i = 0; i < len; i++) {
+        float v = 0;
+        for (int j = 0; j < nb; j++)
+            v += in[j][i] * coeff[j];
+        out[i] = v;
+    }
+}
+
+/* 16 bit coefficients applied to input pairs, then rounded, shifted and
+ * saturated, all in 32 bits */
+static void mix_n_1_int16_ref(int16_t *out, const int16_t **in, const uint8_t *coeffp,
+                              int nb, int len)
+{
+    int shift = AV_RN32(coeffp);
+    const int16_t *coeff = (const int16_t *)(coeffp + 4);
+
+    for (int i = 0; i < len; i++) {
+        uint32_t v = 0;
+        for (int j = 0; j < nb; j += 2)
+            v += (uint32_t)(in[j][i] * coeff[j]) + (uint32_t)(in[j + 1][i] * coeff[j + 1]);
+        v += (1U << shift) >> 1;
+        out[i] = av_clip_int16((int32_t)v >> shift);
+    }
+}
+
+/* 32 bit Q15 coefficients, 64 bit sums */
+static void mix_n_1_int32_ref(int32_t *out, const int32_t **in, const int32_t *coeff,
+                              int nb, int len)
+{
+    for (int i = 0; i < len; i++) {
+        int64_t v = 0;
+        for (int j = 0; j < nb; j++)
+            v += in[j][i] * (int64_t)coeff[j];
+        out[i] = (v + 16384) >> 15;
+    }
+}
+
+static void check_mix_n_1(enum AVSampleFormat fmt, const char *name)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [MAX_INPUTS], [LEN * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst_ref, [LEN * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst_new, [LEN * 4]);
+    const void *ins[MAX_INPUTS + 1];
+    double matrix[MAX_INPUTS];
+    int bps = av_get_bytes_per_sample(fmt);
+
+    declare_func(void, void *out, const void **in, void *coeffp,
+                 integer nb, integer len);
+
+    for (int nb = MIN_INPUTS; nb <= MAX_INPUTS; nb++) {
+        SwrContext *s;
+
+        for (int j = 0; j < nb; j++) {
+            /* nonzero, so every input is used, and large enough for the
+             * s16 sum to saturate */
+            matrix[j] = ((int)(rnd() % 1999) - 999) / 1000.0;
+            if (!matrix[j])
+                matrix[j] = 0.5;
+        }
+
+        s = alloc_rematrix(fmt, nb, matrix);
+        if (!s) {
+            fail();
+            return;
+        }
+
+        if (check_func(s->mix_n_1_simd, "mix_n_1_%s_%d", name, nb)) {
+            for (int j = 0; j < nb; j++) {
+                if (fmt == AV_SAMPLE_FMT_FLTP) {
+                    for (int i = 0; i < LEN; i++)
+                        ((float *)src[j])[i] = (int)(rnd() & 0xFFFF) / 32768.0f - 1.0f;
+                } else if (fmt == AV_SAMPLE_FMT_S32P) {
+                    for (int i = 0; i < LEN; i++)
+                        ((int32_t *)src[j])[i] = rnd();
+                } else {
+                    for (int i = 0; i < LEN; i++)
+                        ((int16_t *)src[j])[i] = rnd();
+                }
+                ins[j] = src[j];
+            }
+            ins[nb] = ins[nb - 1];
+
+            memset(dst_ref, 0, LEN * bps);
+            memset(dst_new, 0, LEN * bps);
+            if (fmt == AV_SAMPLE_FMT_FLTP)
+                mix_n_1_float_ref((float *)dst_ref, (const float **)ins,
+                                  (const float *)s->native_simd_n_matrix, nb, LEN);
+            else if (fmt == AV_SAMPLE_FMT_S32P)
+                mix_n_1_int32_ref((int32_t *)dst_ref, (const int32_t **)ins,
+                                  (const int32_t *)s->native_simd_n_matrix, nb, LEN);
+            else
+                mix_n_1_int16_ref((int16_t *)dst_ref, (const int16_t **)ins,
+                                  s->native_simd_n_matrix, nb, LEN);
+            call_new(dst_new, ins, s->native_simd_n_matrix, nb, LEN);
+
+            if (fmt == AV_SAMPLE_FMT_FLTP) {
+                if (!float_near_abs_eps_array((float *)dst_ref, (float *)dst_new,
+                                              FLT_EPSILON, LEN))
+                    fail();
+            } else if (memcmp(dst_ref, dst_new, LEN * bps)) {
+                fail();
+            }
+
+            bench_new(dst_new, ins, s->native_simd_n_matrix, nb, LEN);
+        }
+        swr_free(&s);
+    }
+}
+
+void checkasm_check_swr_rematrix(void)
+{
+    check_mix_n_1(AV_SAMPLE_FMT_FLTP, "float");
+    report("mix_n_1_float");
+
+    check_mix_n_1(AV_SAMPLE_FMT_S16P, "int16");
+    report("mix_n_1_int16");
+
+    check_mix_n_1(AV_SAMPLE_FMT_S32P, "int32");
+    report("mix_n_1_int32");
+}
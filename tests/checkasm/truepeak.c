@@ -0,0 +1,61 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <float.h>
+
+#include "libavfilter/truepeak.h"
+#include "libavutil/mem_internal.h"
+#include "checkasm.h"
+
+#define LEN 256
+
+void checkasm_check_truepeak(void)
+{
+    LOCAL_ALIGNED_32(double, src, [LEN + TRUEPEAK_TAPS - 1]);
+    LOCAL_ALIGNED_32(double, coeffs, [2 * TRUEPEAK_TAPS * 4]);
+    TruePeakDSPContext dsp;
+
+    declare_func_float(double, const double *src, const double *coeffs,
+                       ptrdiff_t len);
+
+    ff_truepeak_dsp_init(&dsp);
+
+    if (check_func(dsp.upsample_max, "upsample_max")) {
+        static const int lens[] = { 4, 12, LEN };
+
+        for (int i = 0; i < LEN + TRUEPEAK_TAPS - 1; i++)
+            src[i] = (double)rnd() / (UINT_MAX >> 1) - 1.0;
+        for (int i = 0; i < 2 * TRUEPEAK_TAPS; i++) {
+            const double c = (double)rnd() / UINT_MAX - 0.5;
+            for (int j = 0; j < 4; j++)
+                coeffs[i * 4 + j] = c;
+        }
+
+        for (int i = 0; i < FF_ARRAY_ELEMS(lens); i++) {
+            double ref, new;
+
+            ref = call_ref(src, coeffs, lens[i]);
+            new = call_new(src, coeffs, lens[i]);
+            if (!double_near_abs_eps(ref, new, 16 * DBL_EPSILON))
+                fail();
+        }
+        bench_new(src, coeffs, LEN);
+    }
+
+    report("upsample_max");
+}
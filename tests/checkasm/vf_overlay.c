@@ -0,0 +1,184 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavfilter/vf_overlay.h"
+#include "libavutil/common.h"
+#include "libavutil/mem_internal.h"
+
+#define WIDTH 256
+#define BUF_SIZE (WIDTH * 4 + 64)
+
+#define FAST_DIV255(x) ((((x) + 128) * 257) >> 16)
+
+enum { STRAIGHT, PREMULT, PREMULTC };
+
+/* Mirrors the per-sample path of blend_plane() in vf_overlay.c. */
+static av_always_inline int blend_row_ref(uint8_t *d8, uint8_t *s8, uint8_t *a8,
+                                          int w, ptrdiff_t alinesize, int bytes,
+                                          int hsub, int vsub, int mode, int step)
+{
+    const ptrdiff_t al = alinesize / bytes;
+    const int max = bytes == 2 ? 1023 : 255;
+
+    w -= hsub;
+    for (int k = 0; k < w; k++) {
+#define RD(p, i) (bytes == 2 ? ((uint16_t *)(p))[i] : (p)[i])
+        int d = RD(d8, k * step), s = RD(s8, k), alpha, v;
+
+        if (hsub && vsub) {
+            alpha = (RD(a8, 2 * k) + RD(a8, 2 * k + 1) +
+                     RD(a8, 2 * k + al) + RD(a8, 2 * k + al + 1)) >> 2;
+        } else if (hsub) {
+            int a0 = RD(a8, 2 * k), a1 = RD(a8, 2 * k + 1);
+            alpha = (a0 + ((a0 + a1) >> 1)) >> 1;
+        } else {
+            alpha = RD(a8, k);
+        }
+#undef RD
+
+        if (bytes == 2)
+            v = (d * (max - alpha) + s * alpha) / max;
+        else if (mode == STRAIGHT)
+            v = FAST_DIV255(d * (255 - alpha) + s * alpha);
+        else if (mode == PREMULT)
+            v = av_clip_uint8(FAST_DIV255(d * (255 - alpha)) + s - 16);
+        else
+            v = av_clip(FAST_DIV255((d - 128) * (255 - alpha)) + s - 128, -128, 128) + 128;
+
+        if (bytes == 2)
+            ((uint16_t *)d8)[k * step] = v;
+        else
+            d8[k * step] = v;
+    }
+    return w;
+}
+
+#define DEF_REF(name, bytes, hsub, vsub, mode, step)                              \
+static int blend_row_##name##_ref(uint8_t *d, uint8_t *da, uint8_t *s,            \
+                                  uint8_t *a, int w, ptrdiff_t alinesize)         \
+{                                                                                 \
+    return blend_row_ref(d, s, a, w, alinesize, bytes, hsub, vsub, mode, step);   \
+}
+
+DEF_REF(44,        1, 0, 0, STRAIGHT, 1)
+DEF_REF(22,        1, 1, 0, STRAIGHT, 1)
+DEF_REF(20,        1, 1, 1, STRAIGHT, 1)
+DEF_REF(20_nv,     1, 1, 1, STRAIGHT, 2)
+DEF_REF(44_pm,     1, 0, 0, PREMULT,  1)
+DEF_REF(44_pmc,    1, 0, 0, PREMULTC, 1)
+DEF_REF(22_pmc,    1, 1, 0, PREMULTC, 1)
+DEF_REF(20_pmc,    1, 1, 1, PREMULTC, 1)
+DEF_REF(20_pmc_nv, 1, 1, 1, PREMULTC, 2)
+DEF_REF(44_10,     2, 0, 0, STRAIGHT, 1)
+DEF_REF(22_10,     2, 1, 0, STRAIGHT, 1)
+DEF_REF(20_10,     2, 1, 1, STRAIGHT, 1)
+
+typedef int (*blend_row_fn)(uint8_t *d, uint8_t *da, uint8_t *s, uint8_t *a,
+                            int w, ptrdiff_t alinesize);
+
+static const struct {
+    const char *name;
+    blend_row_fn ref;
+    int format, pix_fmt, alpha_format, plane;
+    int bytes, step;
+} tests[] = {
+    { "44",        blend_row_44_ref,        OVERLAY_FORMAT_YUV444,    AV_PIX_FMT_YUV444P,   0, 0, 1, 1 },
+    { "22",        blend_row_22_ref,        OVERLAY_FORMAT_YUV422,    AV_PIX_FMT_YUV422P,   0, 1, 1, 1 },
+    { "20",        blend_row_20_ref,        OVERLAY_FORMAT_YUV420,    AV_PIX_FMT_YUV420P,   0, 1, 1, 1 },
+    { "20_nv",     blend_row_20_nv_ref,     OVERLAY_FORMAT_YUV420,    AV_PIX_FMT_NV12,      0, 1, 1, 2 },
+    { "44_pm",     blend_row_44_pm_ref,     OVERLAY_FORMAT_YUV444,    AV_PIX_FMT_YUV444P,   1, 0, 1, 1 },
+    { "44_pmc",    blend_row_44_pmc_ref,    OVERLAY_FORMAT_YUV444,    AV_PIX_FMT_YUV444P,   1, 1, 1, 1 },
+    { "22_pmc",    blend_row_22_pmc_ref,    OVERLAY_FORMAT_YUV422,    AV_PIX_FMT_YUV422P,   1, 1, 1, 1 },
+    { "20_pmc",    blend_row_20_pmc_ref,    OVERLAY_FORMAT_YUV420,    AV_PIX_FMT_YUV420P,   1, 1, 1, 1 },
+    { "20_pmc_nv", blend_row_20_pmc_nv_ref, OVERLAY_FORMAT_YUV420,    AV_PIX_FMT_NV21,      1, 1, 1, 2 },
+    { "44_10",     blend_row_44_10_ref,     OVERLAY_FORMAT_YUV444P10, AV_PIX_FMT_YUV444P10, 0, 1, 2, 1 },
+    { "22_10",     blend_row_22_10_ref,     OVERLAY_FORMAT_YUV422P10, AV_PIX_FMT_YUV422P10, 0, 1, 2, 1 },
+    { "20_10",     blend_row_20_10_ref,     OVERLAY_FORMAT_YUV420P10, AV_PIX_FMT_YUV420P10, 0, 1, 2, 1 },
+};
+
+static void randomize_buffer(uint8_t *buf, int size, int bytes)
+{
+    for (int i = 0; i < size / bytes; i++) {
+        if (bytes == 2)
+            ((uint16_t *)buf)[i] = rnd() & 0x3ff;
+        else
+            buf[i] = rnd();
+    }
+}
+
+static void check_blend_row(int t)
+{
+    LOCAL_ALIGNED_32(uint8_t, dst_ref, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst_new, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst_exp, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, src,     [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, alpha,   [2 * BUF_SIZE]);
+    const int bytes = tests[t].bytes;
+    const ptrdiff_t alinesize = BUF_SIZE;
+    OverlayContext s = { 0 };
+    int w = WIDTH - (rnd() & 15);
+
+    declare_func(int, uint8_t *d, uint8_t *da, uint8_t *s, uint8_t *a,
+                 int w, ptrdiff_t alinesize);
+
+    s.blend_row[tests[t].plane] = tests[t].ref;
+#if ARCH_X86
+    ff_overlay_init_x86(&s, tests[t].format, tests[t].pix_fmt,
+                        tests[t].alpha_format, 0);
+#endif
+
+    if (check_func(s.blend_row[tests[t].plane], "overlay_row_%s", tests[t].name)) {
+        const int size = w * tests[t].step * bytes;
+        int ret_ref, ret_new;
+
+        randomize_buffer(dst_ref, BUF_SIZE, bytes);
+        randomize_buffer(src,     BUF_SIZE, bytes);
+        randomize_buffer(alpha,   2 * BUF_SIZE, bytes);
+        /* make fully transparent and opaque runs likely */
+        for (int i = 0; i < 2 * BUF_SIZE / bytes; i += 16) {
+            int v = rnd() % 3;
+            for (int j = i; v < 2 && j < i + 8; j++) {
+                if (bytes == 2)
+                    ((uint16_t *)alpha)[j] = v ? 1023 : 0;
+                else
+                    alpha[j] = v ? 255 : 0;
+            }
+        }
+        memcpy(dst_new, dst_ref, BUF_SIZE);
+        memcpy(dst_exp, dst_ref, BUF_SIZE);
+
+        ret_ref = call_ref(dst_ref, NULL, src, alpha, w, alinesize);
+        ret_new = call_new(dst_new, NULL, src, alpha, w, alinesize);
+        if (ret_new < 0 || ret_new > ret_ref)
+            fail();
+        ret_new = av_clip(ret_new, 0, ret_ref);
+        memcpy(dst_exp, dst_ref, ret_new * tests[t].step * bytes);
+        if (memcmp(dst_exp, dst_new, size))
+            fail();
+        bench_new(dst_new, NULL, src, alpha, w, alinesize);
+    }
+}
+
+void checkasm_check_vf_overlay(void)
+{
+    for (int t = 0; t < FF_ARRAY_ELEMS(tests); t++)
+        check_blend_row(t);
+    report("blend_row");
+}
@@ -617,6 +617,67 @@ concat(){
     fi
 }
 
+loudnorm_stats(){
+    src=$1
+    filter_args=$2
+
+    # the measurements loudnorm prints when it is closed, one per line
+    ffmpeg -auto_conversion_filters -i $src \
+           -af loudnorm=print_format=json${filter_args:+:$filter_args} -f null - 2>&1 |
+        tr -d '\r' | sed -n 's/^[[:space:]]*"\([a-z_]*\)" : "\([^"]*\)",\{0,1\}$/\1 \2/p'
+}
+
+loudnorm_precision(){
+    src=$1
+    filter_args=$2
+
+    double="${outdir}/${test}.double"
+    float="${outdir}/${test}.float"
+    cleanfiles="$cleanfiles $double $float"
+
+    loudnorm_stats $src "precision=double${filter_args:+:$filter_args}" > $double || return
+    loudnorm_stats $src "precision=float${filter_args:+:$filter_args}" > $float || return
+    # the single precision measurements must be within 0.1 LU (or dB) of
+    # the double precision ones
+    awk 'NR == FNR { ref[$1] = $2; next }
+         $2 !~ /[0-9]/ { print $1, ($2 == ref[$1]) ? "ok" : "differs: " $2; next }
+         { d = $2 - ref[$1]; print $1, (d >= -0.1 && d <= 0.1) ? "ok" : "differs by " d }' \
+        $double $float
+}
+
+ac3_analysis(){
+    src=$1
+    decoder=$2
+    filter_args=$3
+
+    ac3="${outdir}/${test}.ac3"
+    normal="${outdir}/${test}.normal"
+    analysis="${outdir}/${test}.analysis"
+    cleanfiles="$cleanfiles $ac3 $normal $analysis"
+
+    ffmpeg -auto_conversion_filters -f lavfi -i $src -c:a ac3_fixed -b:a 192k \
+           -f ac3 -y $ac3 || return
+    ffmpeg -auto_conversion_filters -c:a $decoder -downmix mono -i $ac3 \
+           -af aanalysis=$filter_args,ametadata=mode=print:file=$normal -f null - || return
+    ffmpeg -auto_conversion_filters -c:a $decoder -analysis 1 -i $ac3 \
+           -af aanalysis=$filter_args,ametadata=mode=print:file=$analysis -f null - || return
+    # the metadata of the analysis mode, with each level checked to be within
+    # 0.1 dB of the one of the normal decoding to mono; levels below -100 dBFS
+    # are decoder noise and only checked to be below it in both
+    awk -F= 'function level(v) { return v ~ /inf/ ? -1000 : v + 0 }
+             NR == FNR { if ($1 ~ /rms_level$/) ref[n++] = level($2); next }
+             /^frame:/ { sub(/.*pts_time:/, ""); t = $0; next }
+             $1 ~ /rms_level$/ {
+                 l = level($2); r = ref[m++]; d = l - r
+                 ok = (l < -100 && r < -100) || (d >= -0.1 && d <= 0.1)
+                 if (l < -100) printf "%s rms_level below -100", t
+                 else          printf "%s rms_level %.1f", t, l
+                 print ok ? " ok" : " differs by " d
+                 next }
+             $1 ~ /silence/ { sub(/.*\./, "", $1); print t, $1, $2 }' \
+        $normal $analysis
+}
+
 venc_data(){
     file=$1
     stream=$2
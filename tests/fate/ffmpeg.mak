@@ -261,3 +261,10 @@ fate-ffmpeg-loopback-decoding: CMD = transcode \
     "rawvideo -s 352x288 -pix_fmt yuv420p" $(TARGET_PATH)/tests/data/vsynth1.yuv nut \
     "-map 0:v:0 -c:v mpeg2video -f null - -flags +bitexact -idct simple -threads $$threads -dec 0:0 -filter_complex '[0:v][dec:0]hstack[stack]' -map '[stack]' -c:v ffv1" ""
 FATE_FFMPEG-$(call ENCDEC2, MPEG2VIDEO, FFV1, NUT, HSTACK_FILTER PIPE_PROTOCOL FRAMECRC_MUXER) += fate-ffmpeg-loopback-decoding
+
+# Test -keyframe_seek_interval on a Matroska file with B-frames, where the
+# dts of a keyframe is earlier than its pts and its index entry.
+fate-ffmpeg-keyframe_seek_interval: CMD = transcode \
+    "lavfi -graph testsrc2=s=160x120:r=25:d=20" "foo" matroska \
+    "-c:v mpeg4 -bf 2 -g 25" "-c copy" "" "" "-keyframe_seek_interval 2"
+FATE_FFMPEG-$(call TRANSCODE, MPEG4, MATROSKA, TESTSRC2_FILTER LAVFI_INDEV) += fate-ffmpeg-keyframe_seek_interval
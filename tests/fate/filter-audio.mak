@@ -133,6 +133,16 @@ fate-filter-firequalizer: CMP = oneoff
 fate-filter-firequalizer: CMP_UNIT = s16
 fate-filter-firequalizer: SIZE_TOLERANCE = 1058400 - 1097208
 
+FATE_AFILTER-$(call FILTERDEMDECENCMUX, LOUDNORM ARESAMPLE, WAV, PCM_S16LE, WRAPPED_AVFRAME, NULL, PIPE_PROTOCOL) += fate-filter-loudnorm-precision
+fate-filter-loudnorm-precision: tests/data/asynth-44100-2.wav
+fate-filter-loudnorm-precision: CMD = loudnorm_precision $(TARGET_PATH)/tests/data/asynth-44100-2.wav
+
+# the second pass of the input measured above, which stays at 44.1 kHz in
+# linear mode, so the peaks are oversampled true peaks
+FATE_AFILTER-$(call FILTERDEMDECENCMUX, LOUDNORM ARESAMPLE, WAV, PCM_S16LE, WRAPPED_AVFRAME, NULL, PIPE_PROTOCOL) += fate-filter-loudnorm-truepeak
+fate-filter-loudnorm-truepeak: tests/data/asynth-44100-2.wav
+fate-filter-loudnorm-truepeak: CMD = loudnorm_stats $(TARGET_PATH)/tests/data/asynth-44100-2.wav measured_I=-7.87:measured_TP=5.24:measured_LRA=6.90:measured_thresh=-17.87:offset=1.74
+
 FATE_AFILTER-$(call FILTERDEMDECENCMUX, PAN, WAV, PCM_S16LE, PCM_S16LE, WAV) += fate-filter-pan-mono1
 fate-filter-pan-mono1: tests/data/asynth-44100-2.wav
 fate-filter-pan-mono1: SRC = $(TARGET_PATH)/tests/data/asynth-44100-2.wav
@@ -183,6 +193,15 @@ fate-filter-pan-downmix2: tests/data/asynth-44100-11.wav
 fate-filter-pan-downmix2: SRC = $(TARGET_PATH)/tests/data/asynth-44100-11.wav
 fate-filter-pan-downmix2: CMD = framecrc -ss 3.14 -i $(SRC) -frames:a 20 -filter:a "pan=5C|c0=0.7*c0+0.7*c10|c1=c9|c2=c8|c3=c7|c4=c6"
 
+FATE_AANALYSIS_SRC = "aevalsrc=0.5*sin(2*PI*440*t)*(lt(t\,1)+gt(t\,4))|0.25*sin(2*PI*660*t)*(lt(t\,1)+gt(t\,4)):s=48000:d=5"
+
+FATE_AFILTER-$(call ALLYES, LAVFI_INDEV AEVALSRC_FILTER AC3_FIXED_ENCODER AC3_MUXER AC3_DEMUXER AC3_DECODER AANALYSIS_FILTER AMETADATA_FILTER ARESAMPLE_FILTER NULL_MUXER) += fate-filter-aanalysis-ac3
+fate-filter-aanalysis-ac3: CMD = ac3_analysis $(FATE_AANALYSIS_SRC) ac3 w=0.5:d=1
+
+FATE_AFILTER-$(call ALLYES, LAVFI_INDEV AEVALSRC_FILTER AC3_FIXED_ENCODER AC3_MUXER AC3_DEMUXER AC3_FIXED_DECODER AANALYSIS_FILTER AMETADATA_FILTER ARESAMPLE_FILTER NULL_MUXER) += fate-filter-aanalysis-ac3-fixed
+fate-filter-aanalysis-ac3-fixed: CMD = ac3_analysis $(FATE_AANALYSIS_SRC) ac3_fixed w=0.5:d=1
+fate-filter-aanalysis-ac3-fixed: REF = $(SRC_PATH)/tests/ref/fate/filter-aanalysis-ac3
+
 FATE_AFILTER-$(call ALLYES, LAVFI_INDEV AEVALSRC_FILTER SILENCEREMOVE_FILTER ARESAMPLE_FILTER) += fate-filter-silenceremove
 fate-filter-silenceremove: CMD = framecrc -auto_conversion_filters -f lavfi -i "aevalsrc=between(t\,1\,2)+between(t\,4\,5)+between(t\,7\,9):d=10:n=8192,silenceremove=start_periods=0:start_duration=0:start_threshold=0:stop_periods=-1:stop_duration=0:stop_threshold=-90dB:window=0:detection=avg"
 
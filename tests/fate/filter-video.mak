@@ -202,6 +202,15 @@ FATE_FILTER_VSYNTH_PGMYUV-$(CONFIG_MERGEPLANES_FILTER) += fate-filter-mergeplane
 fate-filter-mergeplanes: tests/data/filtergraphs/mergeplanes
 fate-filter-mergeplanes: CMD = framecrc -c:v pgmyuv -i $(SRC) -c:v pgmyuv -i $(SRC) -/filter_complex $(TARGET_PATH)/tests/data/filtergraphs/mergeplanes
 
+# a gray output must not be used as the source of a color one, so both
+# chains have to give the same result
+FATE_FILTER_VSYNTH_PGMYUV-$(CONFIG_MULTISCALE_FILTER) += fate-filter-multiscale-cascade fate-filter-multiscale-nocascade fate-filter-multiscale-ladder
+fate-filter-multiscale-cascade: tests/data/filtergraphs/multiscale-cascade
+fate-filter-multiscale-nocascade: tests/data/filtergraphs/multiscale-nocascade
+fate-filter-multiscale-ladder: tests/data/filtergraphs/multiscale-ladder
+fate-filter-multiscale-%: CMD = framecrc -c:v pgmyuv -i $(SRC) -/filter_complex $(TARGET_PATH)/tests/data/filtergraphs/$(@:fate-filter-%=%) -frames:v 5
+fate-filter-multiscale-cascade: REF = $(SRC_PATH)/tests/ref/fate/filter-multiscale-nocascade
+
 FATE_FILTER_VSYNTH_PGMYUV-$(CONFIG_HSTACK_FILTER) += fate-filter-hstack
 fate-filter-hstack: tests/data/filtergraphs/hstack
 fate-filter-hstack: CMD = framecrc -c:v pgmyuv -i $(SRC) -c:v pgmyuv -i $(SRC) -/filter_complex $(TARGET_PATH)/tests/data/filtergraphs/hstack
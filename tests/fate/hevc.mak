@@ -210,6 +210,34 @@ FATE_HEVC-$(call FRAMECRC, HEVC, HEVC, HEVC_PARSER SCALE_FILTER) +=         \
                                                     $(HEVC_TESTS_422_10BIN) \
                                                     $(HEVC_TESTS_444_12BIT) \
 
+# the loop filters on a helper thread, without and with frame threading,
+# must match the plain conformance output
+HEVC_SAMPLES_FILTER_THREAD_8BIT =   \
+    DBLK_A_SONY_3                   \
+    DBLK_E_VIXS_2                   \
+    SAO_A_MediaTek_4                \
+    SAO_D_Samsung_5                 \
+    TILES_A_Cisco_2                 \
+    WPP_A_ericsson_MAIN_2           \
+
+HEVC_SAMPLES_FILTER_THREAD_10BIT =  \
+    DBLK_A_MAIN10_VIXS_3            \
+    WPP_A_ericsson_MAIN10_2         \
+
+define FATE_HEVC_FILTER_THREAD_TEST
+fate-hevc-filter-thread-$(1) fate-hevc-filter-thread-frame-$(1): CMD = framecrc -flags unaligned -filter_thread 1 -i $(TARGET_SAMPLES)/hevc-conformance/$(1).bit $(2)
+fate-hevc-filter-thread-$(1) fate-hevc-filter-thread-frame-$(1): REF = $(SRC_PATH)/tests/ref/fate/hevc-conformance-$(1)
+fate-hevc-filter-thread-$(1): THREADS = 1
+fate-hevc-filter-thread-frame-$(1): THREADS = 4
+fate-hevc-filter-thread-frame-$(1): THREAD_TYPE = frame
+FATE_HEVC_FILTER_THREAD += fate-hevc-filter-thread-$(1) fate-hevc-filter-thread-frame-$(1)
+endef
+
+$(foreach N,$(HEVC_SAMPLES_FILTER_THREAD_8BIT),$(eval $(call FATE_HEVC_FILTER_THREAD_TEST,$(N),-pix_fmt yuv420p)))
+$(foreach N,$(HEVC_SAMPLES_FILTER_THREAD_10BIT),$(eval $(call FATE_HEVC_FILTER_THREAD_TEST,$(N),-pix_fmt yuv420p10le -vf scale)))
+
+FATE_HEVC-$(call FRAMECRC, HEVC, HEVC, HEVC_PARSER SCALE_FILTER) += $(FATE_HEVC_FILTER_THREAD)
+
 fate-hevc-paramchange-yuv420p-yuv420p10: CMD = framecrc -i $(TARGET_SAMPLES)/hevc/paramchange_yuv420p_yuv420p10.hevc -fps_mode passthrough -sws_flags area+accurate_rnd+bitexact
 FATE_HEVC-$(call FRAMECRC, HEVC, HEVC, HEVC_PARSER SCALE_FILTER LARGE_TESTS) += fate-hevc-paramchange-yuv420p-yuv420p10
 
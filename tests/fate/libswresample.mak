@@ -1099,3 +1099,11 @@ fate-swr-audioconvert: FUZZ = 0
 FATE_SWR += $(FATE_SWR_AUDIOCONVERT-yes)
 FATE_FFMPEG += $(FATE_SWR)
 fate-swr: $(FATE_SWR)
+
+FATE_LIBSWRESAMPLE += fate-swr-threads
+fate-swr-threads: libswresample/tests/threads$(EXESUF)
+fate-swr-threads: CMD = run libswresample/tests/threads$(EXESUF) 48000 44100 8 4 1
+fate-swr-threads: CMP = null
+
+FATE-$(CONFIG_SWRESAMPLE) += $(FATE_LIBSWRESAMPLE)
+fate-libswresample: $(FATE_LIBSWRESAMPLE)
@@ -106,6 +106,9 @@ fate-sub-webvtt2: CMD = fmtstdout ass -i $(TARGET_SAMPLES)/sub/WebVTT_extended_t
 FATE_SUBTITLES-$(call ALLYES, SRT_DEMUXER SUBRIP_DECODER WEBVTT_ENCODER WEBVTT_MUXER) += fate-sub-webvttenc
 fate-sub-webvttenc: CMD = fmtstdout webvtt -i $(TARGET_SAMPLES)/sub/SubRip_capability_tester.srt
 
+FATE_SUBTITLES-$(call ALLYES, SRT_DEMUXER TEXT2WEBVTT_BSF WEBVTT_MUXER) += fate-sub-text2webvtt
+fate-sub-text2webvtt: CMD = fmtstdout webvtt -i $(TARGET_SAMPLES)/sub/SubRip_capability_tester.srt -c:s copy -bsf:s text2webvtt
+
 FATE_SUBTITLES-$(call ALLYES, SRT_DEMUXER SUBRIP_DECODER TEXT_ENCODER SRT_MUXER) += fate-sub-textenc
 fate-sub-textenc: CMD = fmtstdout srt -i $(TARGET_SAMPLES)/sub/SubRip_capability_tester.srt -c:s text
 
@@ -130,6 +133,35 @@ fate-sub-dvb: CMD = framecrc -i $(TARGET_SAMPLES)/sub/dvbsubtest_filter.ts -map
 FATE_SUBTITLES-$(call ALLYES, FILE_PROTOCOL PIPE_PROTOCOL SRT_DEMUXER SUBRIP_DECODER TTML_ENCODER TTML_MUXER) += fate-sub-ttmlenc
 fate-sub-ttmlenc: CMD = fmtstdout ttml -i $(TARGET_SAMPLES)/sub/SubRip_capability_tester.srt
 
+# The same as above, with the events indexed when opening and read on demand
+FATE_SUBTITLES_ASS-$(call DEMDEC, SRT, SUBRIP) += fate-sub-srt-lazy
+fate-sub-srt-lazy: CMD = fmtstdout ass -lazy_load 1 -i $(TARGET_SAMPLES)/sub/SubRip_capability_tester.srt
+fate-sub-srt-lazy: REF = $(SRC_PATH)/tests/ref/fate/sub-srt
+
+FATE_SUBTITLES_ASS-$(call DEMDEC, SRT, SUBRIP) += fate-sub-srt-badsyntax-lazy
+fate-sub-srt-badsyntax-lazy: CMD = fmtstdout ass -lazy_load 1 -i $(TARGET_SAMPLES)/sub/badsyntax.srt
+fate-sub-srt-badsyntax-lazy: REF = $(SRC_PATH)/tests/ref/fate/sub-srt-badsyntax
+
+FATE_SUBTITLES-$(call ALLYES, SRT_DEMUXER SUBRIP_DECODER SRT_MUXER) += fate-sub-srt-madness-timeshift-lazy
+fate-sub-srt-madness-timeshift-lazy: CMD = fmtstdout srt -lazy_load 1 -itsoffset 3.14 -i $(TARGET_SAMPLES)/sub/madness.srt -c:s copy
+fate-sub-srt-madness-timeshift-lazy: REF = $(SRC_PATH)/tests/ref/fate/sub-srt-madness-timeshift
+
+FATE_SUBTITLES_ASS-$(call DEMDEC, ASS, ASS) += fate-sub-ass-to-ass-transcode-lazy
+fate-sub-ass-to-ass-transcode-lazy: CMD = fmtstdout ass -lazy_load 1 -i $(TARGET_SAMPLES)/sub/1ededcbd7b.ass
+fate-sub-ass-to-ass-transcode-lazy: REF = $(SRC_PATH)/tests/ref/fate/sub-ass-to-ass-transcode
+
+FATE_SUBTITLES_ASS-$(CONFIG_ASS_DEMUXER) += fate-sub-ssa-to-ass-remux-lazy
+fate-sub-ssa-to-ass-remux-lazy: CMD = fmtstdout ass -lazy_load 1 -i $(TARGET_SAMPLES)/sub/a9-misc.ssa -c copy
+fate-sub-ssa-to-ass-remux-lazy: REF = $(SRC_PATH)/tests/ref/fate/sub-ssa-to-ass-remux
+
+FATE_SUBTITLES_ASS-$(call DEMDEC, WEBVTT, WEBVTT) += fate-sub-webvtt-lazy
+fate-sub-webvtt-lazy: CMD = fmtstdout ass -lazy_load 1 -i $(TARGET_SAMPLES)/sub/WebVTT_capability_tester.vtt
+fate-sub-webvtt-lazy: REF = $(SRC_PATH)/tests/ref/fate/sub-webvtt
+
+FATE_SUBTITLES_ASS-$(call DEMDEC, WEBVTT, WEBVTT) += fate-sub-webvtt2-lazy
+fate-sub-webvtt2-lazy: CMD = fmtstdout ass -lazy_load 1 -i $(TARGET_SAMPLES)/sub/WebVTT_extended_tester.vtt
+fate-sub-webvtt2-lazy: REF = $(SRC_PATH)/tests/ref/fate/sub-webvtt2
+
 FATE_SUBTITLES-$(call ENCMUX, ASS, ASS) += $(FATE_SUBTITLES_ASS-yes)
 FATE_SUBTITLES += $(FATE_SUBTITLES-yes)
 